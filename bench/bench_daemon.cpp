@@ -0,0 +1,82 @@
+/*
+ * load test of the planning daemon, latency of concurrent clients
+ *
+ * usage: bench_daemon socket_path map_file [N] [requests] [clients]
+ *        [time_limit_ms] [map_id]
+ * each client sends random start/goal sets of the map one after another
+ */
+#include <lacam.hpp>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0]
+              << " socket_path map_file [N] [requests] [clients]"
+                 " [time_limit_ms] [map_id]"
+              << std::endl;
+    return 1;
+  }
+  const std::string socket_path = argv[1];
+  const std::string map_filename = argv[2];
+  const auto N = argc > 3 ? std::stoi(argv[3]) : 100;
+  const auto num_requests = argc > 4 ? std::stoi(argv[4]) : 100;
+  const auto num_clients = argc > 5 ? std::stoi(argv[5]) : 4;
+  const auto time_limit_ms = argc > 6 ? std::stoi(argv[6]) : 1000;
+  const auto map_id = argc > 7 ? std::stoi(argv[7]) : 0;
+
+  auto requests = std::vector<protocol::Request>();
+  for (auto k = 0; k < num_requests; ++k) {
+    const auto ins = Instance(map_filename, N, k);
+    auto &req = requests.emplace_back();
+    req = protocol::Request{map_id, time_limit_ms, k, {}, {}};
+    for (auto v : ins.starts) req.starts.push_back(v->index);
+    for (auto v : ins.goals) req.goals.push_back(v->index);
+  }
+
+  // requests are taken in order by clients
+  auto next = std::atomic<int>(0);
+  auto latencies = std::vector<double>(num_requests, 0);
+  auto status = std::vector<int>(num_requests, -1);
+  auto client = [&] {
+    auto fd = protocol::connect(socket_path);
+    if (fd < 0) return;
+    auto res = protocol::Response();
+    for (int k = next++; k < num_requests; k = next++) {
+      auto timer = Deadline();
+      if (!protocol::write_request(fd, requests[k]) ||
+          !protocol::read_response(fd, res)) {
+        break;
+      }
+      latencies[k] = timer.elapsed_ms();
+      status[k] = res.status;
+    }
+    ::close(fd);
+  };
+  auto timer = Deadline();
+  auto threads = std::vector<std::thread>();
+  for (auto k = 0; k < num_clients; ++k) threads.emplace_back(client);
+  for (auto &th : threads) th.join();
+  const auto wall_time_ms = timer.elapsed_ms();
+
+  auto done = std::vector<double>();
+  auto num_solved = 0;
+  for (auto k = 0; k < num_requests; ++k) {
+    if (status[k] < 0) continue;
+    done.push_back(latencies[k]);
+    num_solved += status[k] == protocol::SUCCESS;
+  }
+  if (done.empty()) {
+    std::cerr << "no response from " << socket_path << std::endl;
+    return 1;
+  }
+  std::sort(done.begin(), done.end());
+  auto percentile = [&](double p) {
+    return done[std::min(done.size() - 1, (size_t)(p * done.size()))];
+  };
+  std::cout << "clients=" << num_clients << "\tresponses=" << done.size()
+            << "\tsolved=" << num_solved << "\tp50_ms=" << percentile(0.5)
+            << "\tp99_ms=" << percentile(0.99) << "\tmax_ms=" << done.back()
+            << "\tthroughput_rps=" << done.size() * 1000.0 / wall_time_ms
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * simulator of lifelong MAPF, agents receive random goals on arrival and
+ * execute the first step of the plan at every tick; reports throughput,
+ * i.e., tasks completed per timestep, and per-tick latencies
+ *
+ * usage: bench_lifelong map_file [N] [timesteps] [horizon] [budget_ms]
+ */
+#include <lacam.hpp>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " map_file [N] [timesteps] [horizon] [budget_ms]"
+              << std::endl;
+    return 1;
+  }
+  const std::string map_filename = argv[1];
+  const auto N = argc > 2 ? std::stoi(argv[2]) : 100;
+  const auto timesteps = argc > 3 ? std::stoi(argv[3]) : 500;
+  const auto horizon = argc > 4 ? std::stoi(argv[4]) : 10;
+  const auto budget_ms = argc > 5 ? std::stoi(argv[5]) : 100;
+
+  const auto ins = Instance(map_filename, N, 0);
+  auto options = PlannerOptions();
+  options.flg_star = false;
+  options.horizon = horizon;
+  auto deadline_setup = Deadline();
+  auto lifelong = Lifelong(&ins, options);
+  const auto setup_ms = deadline_setup.elapsed_ms();
+
+  auto MT = std::mt19937(0);
+  auto &V = ins.G->V;
+  auto times = std::vector<double>();
+  auto num_tasks = 0;
+  auto num_stuck = 0;  // ticks without any step
+  auto sum_pending = 0;
+  auto C = ins.starts;
+  for (auto t = 0; t < timesteps; ++t) {
+    for (auto i = 0; i < N; ++i) {
+      if (C[i] != lifelong.goals_requested[i]) continue;
+      if (t > 0) ++num_tasks;
+      lifelong.set_goal(i, V[get_random_int(MT, 0, V.size() - 1)]);
+    }
+    auto deadline = Deadline(budget_ms);
+    auto plan = lifelong.tick(C, &deadline, t);
+    times.push_back(deadline.elapsed_ns() / 1000000);
+    sum_pending += lifelong.get_num_pending();
+    if (plan.size() < 2) {
+      ++num_stuck;
+      continue;
+    }
+    C = plan[1];
+  }
+
+  std::sort(times.begin(), times.end());
+  std::cout << "tasks=" << num_tasks
+            << "\tthroughput=" << (double)num_tasks / timesteps
+            << "\tstuck=" << num_stuck << "\tsetup_ms=" << setup_ms
+            << "\tp50_ms=" << times[times.size() / 2]
+            << "\tp99_ms=" << times[times.size() * 99 / 100]
+            << "\tmax_ms=" << times.back() << std::endl;
+  std::cout << "goal_updates=" << lifelong.num_goal_updates
+            << "\trows_computed=" << lifelong.num_rows_computed
+            << "\tdist_cache_hits=" << lifelong.dist_cache.num_hits
+            << "\tmean_pending=" << (double)sum_pending / timesteps
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * per-tick latency of receding-horizon planning on random start/goal sets,
+ * executing the first steps of each plan until all agents reach their goals;
+ * compared with one full solve
+ *
+ * usage: bench_receding_horizon map_file [N] [horizon] [budget_ms]
+ *        [steps_per_tick] [ticks]
+ */
+#include <lacam.hpp>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " map_file [N] [horizon] [budget_ms] [steps_per_tick] [ticks]"
+              << std::endl;
+    return 1;
+  }
+  const std::string map_filename = argv[1];
+  const auto N = argc > 2 ? std::stoi(argv[2]) : 1000;
+  const auto horizon = argc > 3 ? std::stoi(argv[3]) : 10;
+  const auto budget_ms = argc > 4 ? std::stoi(argv[4]) : 100;
+  const auto steps_per_tick = argc > 5 ? std::stoi(argv[5]) : 1;
+  const auto max_ticks = argc > 6 ? std::stoi(argv[6]) : 1000;
+
+  const auto ins = Instance(map_filename, N, 0);
+  auto options = PlannerOptions();
+  options.flg_star = false;
+
+  // full plan, as reference
+  {
+    auto deadline = Deadline(60000);
+    auto solution = solve(ins, 0, &deadline, 0, options);
+    std::cout << "full\tsolved=" << !solution.empty()
+              << "\tcomp_time_ms=" << deadline.elapsed_ms()
+              << "\tmakespan=" << get_makespan(solution) << std::endl;
+  }
+
+  options.horizon = horizon;
+  auto deadline_setup = Deadline(60000);
+  auto controller = RecedingHorizon(&ins, options, 0, &deadline_setup);
+  const auto setup_ms = deadline_setup.elapsed_ms();
+  auto times = std::vector<double>();
+  auto num_short = 0;  // budget exhausted before the horizon
+  auto C = ins.starts;
+  while (controller.num_ticks < max_ticks && !is_same_config(C, ins.goals)) {
+    auto deadline = Deadline(budget_ms);
+    auto plan = controller.tick(C, &deadline, controller.num_ticks);
+    times.push_back(deadline.elapsed_ns() / 1000000);
+    if (plan.size() < 2) break;
+    if ((int)plan.size() < horizon + 1 &&
+        !is_same_config(plan.back(), ins.goals)) {
+      ++num_short;
+    }
+    C = plan[std::min(steps_per_tick, (int)plan.size() - 1)];
+  }
+  if (times.empty()) return 1;
+  std::sort(times.begin(), times.end());
+  std::cout << "horizon\tsolved=" << is_same_config(C, ins.goals)
+            << "\tticks=" << times.size() << "\tshort=" << num_short
+            << "\tsetup_ms=" << setup_ms
+            << "\tp50_ms=" << times[times.size() / 2]
+            << "\tp99_ms=" << times[times.size() * 99 / 100]
+            << "\tmax_ms=" << times.back() << std::endl;
+  return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * wall-time and quality of SUO w.r.t. the number of threads
+ *
+ * usage: bench_scatter map_file scen_file N [threads ...]
+ */
+#include <lacam.hpp>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0] << " map_file scen_file N [threads ...]"
+              << std::endl;
+    return 1;
+  }
+  const auto ins = Instance(argv[2], argv[1], std::stoi(argv[3]));
+  if (!ins.is_valid(1)) return 1;
+  auto D = DistTable(ins);
+  auto threads_list = std::vector<int>();
+  for (auto k = 4; k < argc; ++k) threads_list.push_back(std::stoi(argv[k]));
+  if (threads_list.empty()) threads_list = {1, 2, 4, 8};
+
+  for (auto threads : threads_list) {
+    auto deadline = Deadline(INT_MAX);
+    auto scatter = Scatter(&ins, &D, &deadline, 0, -1, 10, false, threads);
+    scatter.construct();
+    std::cout << "threads=" << threads
+              << "\twall_time_ms=" << deadline.elapsed_ms()
+              << "\tcollision_cnt=" << scatter.CT.collision_cnt
+              << "\tsum_of_path_length=" << scatter.sum_of_path_length
+              << "\treplans=" << scatter.num_replans << std::endl;
+  }
+  return 0;
+}
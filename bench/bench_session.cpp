@@ -0,0 +1,77 @@
+/*
+ * per-request latency of a solver session vs. fresh solve calls, on random
+ * start/goal sets of one map; planners stop at the initial solution
+ *
+ * usage: bench_session map_file [N] [requests] [time_limit_ms]
+ */
+#include <lacam.hpp>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " map_file [N] [requests] [time_limit_ms]" << std::endl;
+    return 1;
+  }
+  const std::string map_filename = argv[1];
+  const auto N = argc > 2 ? std::stoi(argv[2]) : 100;
+  const auto num_requests = argc > 3 ? std::stoi(argv[3]) : 20;
+  const auto time_limit_ms = argc > 4 ? std::stoi(argv[4]) : 10000;
+
+  auto options = PlannerOptions();
+  options.flg_star = false;
+
+  // requests, as indexes of the grid
+  auto requests = std::vector<std::array<std::vector<int>, 2>>();
+  for (auto k = 0; k < num_requests; ++k) {
+    const auto ins = Instance(map_filename, N, k);
+    auto &req = requests.emplace_back();
+    for (auto v : ins.starts) req[0].push_back(v->index);
+    for (auto v : ins.goals) req[1].push_back(v->index);
+  }
+
+  auto report = [&](const std::string &name, std::vector<double> &times,
+                    const int num_solved) {
+    const auto sum = std::accumulate(times.begin(), times.end(), 0.0);
+    std::sort(times.begin(), times.end());
+    std::cout << name << "\tsolved=" << num_solved << "/" << times.size()
+              << "\tmean_ms=" << sum / times.size()
+              << "\tmedian_ms=" << times[times.size() / 2]
+              << "\tmax_ms=" << times.back() << std::endl;
+  };
+
+  // everything from scratch
+  {
+    auto times = std::vector<double>();
+    auto num_solved = 0;
+    for (auto &req : requests) {
+      auto deadline = Deadline(time_limit_ms);
+      const auto ins = Instance(map_filename, req[0], req[1]);
+      auto solution = solve(ins, 0, &deadline, 0, options);
+      times.push_back(deadline.elapsed_ms());
+      num_solved += !solution.empty();
+    }
+    report("fresh", times, num_solved);
+  }
+
+  // graph & distances kept, including the cold first request
+  {
+    auto times = std::vector<double>();
+    auto num_solved = 0;
+    auto deadline_setup = Deadline(time_limit_ms);
+    auto session = SolverSession(map_filename, options);
+    const auto setup_ms = deadline_setup.elapsed_ms();
+    for (auto &req : requests) {
+      auto deadline = Deadline(time_limit_ms);
+      auto solution = session.solve(req[0], req[1], &deadline);
+      times.push_back(deadline.elapsed_ms());
+      num_solved += !solution.empty();
+    }
+    report("session", times, num_solved);
+    std::cout << "session_setup_ms=" << setup_ms
+              << "\tdist_cache_hits=" << session.dist_cache.num_hits
+              << "\tdist_cache_misses=" << session.dist_cache.num_misses
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <argparse/argparse.hpp>
+#include <csignal>
+#include <iostream>
+#include <lacam.hpp>
+
+static Server *server = nullptr;
+
+static void handle_signal(int) { server->stop(); }
+
+int main(int argc, char *argv[])
+{
+  // arguments parser
+  argparse::ArgumentParser program("lacam3-daemon", "0.1.0");
+  program.add_argument("-m", "--map")
+      .help("map file, repeatable; map_id is the order of appearance")
+      .append()
+      .required();
+  program.add_argument("-S", "--socket")
+      .help("path of the Unix domain socket")
+      .default_value(std::string("/tmp/lacam3.sock"));
+  program.add_argument("--max-time-limit")
+      .help("maximum time limit of requests (ms), larger ones are capped")
+      .default_value(std::string("60000"));
+  program.add_argument("-v", "--verbose")
+      .help("verbose")
+      .default_value(std::string("1"));
+
+  // solver parameters, shared by all requests
+  program.add_argument("--no-star")
+      .help("return the initial solution instead of refining it until the "
+            "time limit of each request")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--threads")
+      .help("total number of solver threads shared by all requests, 0 -> "
+            "hardware concurrency but at least one for each refiner and one "
+            "for the search")
+      .default_value(std::string("0"));
+  program.add_argument("--pibt-num")
+      .help("used in Monte-Carlo configuration generation")
+      .default_value(std::string("10"));
+  program.add_argument("--no-scatter")
+      .help("turn off SUO")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--no-refiner")
+      .help("turn off iterative refinement")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--refiner-num")
+      .help("specify the number of refiners")
+      .default_value(std::string("4"));
+  program.add_argument("--random-insert-prob1")
+      .help("probability of inserting the start node")
+      .default_value(std::string("0.001"));
+  program.add_argument("--dist-cache-capacity")
+      .help("distance rows kept for each map, 0 -> unlimited")
+      .default_value(std::string("0"));
+  try {
+    program.parse_known_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  const auto verbose = std::stoi(program.get<std::string>("verbose"));
+  const auto map_names = program.get<std::vector<std::string>>("map");
+  const auto socket_path = program.get<std::string>("socket");
+  const auto max_time_limit_ms =
+      std::stoi(program.get<std::string>("max-time-limit"));
+  auto options = PlannerOptions();
+  options.flg_star = !program.get<bool>("no-star");
+  options.pibt_num = std::stoi(program.get<std::string>("pibt-num"));
+  options.flg_scatter = !program.get<bool>("no-scatter");
+  options.flg_refiner = !program.get<bool>("no-refiner");
+  options.refiner_num = std::stoi(program.get<std::string>("refiner-num"));
+  options.random_insert_prob1 =
+      std::stof(program.get<std::string>("random-insert-prob1"));
+  set_num_threads(std::stoi(program.get<std::string>("threads")), options);
+  const auto capacity =
+      std::stoi(program.get<std::string>("dist-cache-capacity"));
+
+  // maps are loaded once, distances are computed on demand and kept
+  auto sessions = std::vector<SolverSession *>();
+  for (auto &map_name : map_names) {
+    auto session = new SolverSession(map_name, options, verbose - 2,
+                                     capacity > 0 ? capacity : SIZE_MAX);
+    if (session->G->size() == 0) {
+      info(0, verbose, "failed to load ", map_name);
+      return 1;
+    }
+    info(1, verbose, "map-", sessions.size(), "\t", map_name,
+         ", vertices: ", session->G->size());
+    sessions.push_back(session);
+  }
+
+  server = new Server(socket_path, sessions, verbose, max_time_limit_ms);
+  if (!server->open()) return 1;
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+  server->run();
+  info(1, verbose, "stopped");
+
+  delete server;
+  for (auto session : sessions) delete session;
+  return 0;
+}
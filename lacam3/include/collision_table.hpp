@@ -7,19 +7,106 @@
 #include "instance.hpp"
 #include "utils.hpp"
 
+// safe interval, [start, end]
+using SI = std::pair<int, int>;
+using SIs = std::vector<SI>;
+
+// view of consecutive safe intervals
+struct SIRange {
+  const SI *first;
+  const SI *last;
+  const SI *begin() const { return first; }
+  const SI *end() const { return last; }
+  int size() const { return last - first; }
+  bool empty() const { return first == last; }
+  const SI &operator[](const int k) const { return first[k]; }
+  const SI &back() const { return *(last - 1); }
+};
+
+// agents at one (vertex, time), short lists are stored inline
+struct CollisionCell {
+  static constexpr int INLINE_SIZE = 3;
+  int cnt;
+  std::array<int, INLINE_SIZE> agents;
+  CollisionCell();
+};
+
+// departure times of a directed edge, distinct & sorted, with counts
+struct EdgeTimes {
+  std::vector<int> times;
+  std::vector<int> cnts;
+};
+
 struct CollisionTable {
-  // vertex, time, agents
-  std::vector<std::vector<std::vector<int>>> body;
+  // vertex -> time-indexed cells, trailing empty cells are compacted
+  std::vector<std::vector<CollisionCell>> body;
+  // agents beyond the inline capacity, key: (vertex, time)
+  std::unordered_map<uint64_t, std::vector<int>> overflow;
+  // vertex -> sorted arrival timesteps of agents staying there
   std::vector<std::vector<int>> body_last;
+  std::vector<std::pair<int, int>> body_last_agent;  // agent -> vertex, time
+  // vertex -> sorted safe intervals w.r.t. occupancy, maintained
+  // incrementally; empty means never occupied
+  std::vector<SIs> safe_intervals;
+  // vertex-v, index-k -> departure times of moves from v->neighbor[k] to v,
+  // i.e., swap conflicts for moves from v to v->neighbor[k]
+  std::vector<std::vector<EdgeTimes>> moves;
   int collision_cnt;
   int N;
 
   CollisionTable(const Instance *ins);
   ~CollisionTable();
 
+  // entries of agent-i are ignored if specified
   int getCollisionCost(const Vertex *v_from, const Vertex *v_to,
-                       const int t_from);
+                       const int t_from, const int i = -1);
   void enrollPath(const int i, Path &path);
   void clearPath(const int i, Path &path);
-  void shrink();
+  void shrink();  // release memory of unused cells
+
+  // queries
+  int get_horizon(const int v_id) const;  // cells beyond are empty
+  int get_agents_num(const int v_id, const int t) const;
+  int get_first_goal_arrival(const int v_id) const;  // INT_MAX if none
+  int get_goal_arrivals_before(const int v_id, const int t) const;
+  template <typename F>
+  void for_each_agent(const int v_id, const int t, F &&func) const;
+
+  // safe intervals before the first goal arrival
+  SIRange get_safe_intervals(const int v_id) const;
+  // index in get_safe_intervals containing t, -1 if none; O(log k)
+  int find_safe_interval(const int v_id, const int t) const;
+
+  // departure in [t_lo, t_hi] from v_from to v_from->neighbor[k] without
+  // swap conflicts, -1 if none; O(log k)
+  int get_earliest_departure(const Vertex *v_from, const int k, const int t_lo,
+                             const int t_hi) const;
+  int get_latest_departure(const Vertex *v_from, const int k, const int t_lo,
+                           const int t_hi) const;
+
+  static constexpr int TIME_INF = INT_MAX - 1;
+
+private:
+  static uint64_t get_key(const int v_id, const int t);
+  void insert(const int v_id, const int t, const int i);
+  void remove(const int v_id, const int t, const int i);
+  void compact(const int v_id);
+  void occupy(const int v_id, const int t);   // split a safe interval
+  void release(const int v_id, const int t);  // merge safe intervals
+  const EdgeTimes *get_moves(const Vertex *v, const int k) const;
+  EdgeTimes *find_moves(const Vertex *v_from, const Vertex *v_to);
+  void add_move(const Vertex *v_from, const Vertex *v_to, const int t);
+  void remove_move(const Vertex *v_from, const Vertex *v_to, const int t);
 };
+
+template <typename F>
+void CollisionTable::for_each_agent(const int v_id, const int t,
+                                    F &&func) const
+{
+  if (t >= (int)body[v_id].size()) return;
+  auto &cell = body[v_id][t];
+  const auto k_max = std::min(cell.cnt, CollisionCell::INLINE_SIZE);
+  for (auto k = 0; k < k_max; ++k) func(cell.agents[k]);
+  if (cell.cnt <= CollisionCell::INLINE_SIZE) return;
+  for (auto j : overflow.at(get_key(v_id, t))) func(j);
+}
@@ -3,21 +3,52 @@
  */
 #pragma once
 
+#include "executor.hpp"
 #include "graph.hpp"
 #include "instance.hpp"
 #include "utils.hpp"
 
+// distances to a goal vertex, index: vertex-id
+using DistRow = std::shared_ptr<const std::vector<int>>;
+
+// BFS, vertices farther than the radius are left at |V|
+DistRow get_dist_row(const Graph *G, const Vertex *goal,
+                     const int radius = INT_MAX);
+
+// BFS results per goal vertex, shared by instances on the same graph
+struct DistCache {
+  const Graph *G;
+  const size_t capacity;  // rows kept, older ones are dropped first
+  std::mutex mtx;
+  std::unordered_map<int, DistRow> rows;  // goal vertex-id -> row
+  std::deque<int> history;                // insertion order of rows
+  int num_hits;
+  int num_misses;
+
+  DistCache(const Graph *_G, const size_t _capacity = SIZE_MAX);
+  DistRow find(const Vertex *goal);  // nullptr if not cached
+  void insert(const Vertex *goal, DistRow row);
+};
+
 struct DistTable {
   const int K;  // number of vertices
-  std::vector<std::vector<int>>
-      table;  // distance table, index: agent-id & vertex-id
+  std::vector<DistRow> rows;
+  std::vector<const int *> table;  // distance table, index: agent-id &
+                                   // vertex-id
   std::vector<std::queue<Vertex *>> OPEN;  // search queue
 
   int get(const int i, const int v_id);   // agent, vertex-id
   int get(const int i, const Vertex *v);  // agent, vertex
 
   DistTable(const Instance &ins);
-  DistTable(const Instance *ins);
+  DistTable(const Instance *ins, DistCache *cache = nullptr);
+  // truncated rows, e.g., for short sub-instances; never cached
+  DistTable(const Instance *ins, const int radius,
+            const TaskPriority priority);
 
-  void setup(const Instance *ins);  // initialization
+  // initialization
+  void setup(const Instance *ins, DistCache *cache,
+             const int radius = INT_MAX,
+             const TaskPriority priority = PRIORITY_HIGH);
+  void set_row(const int i, DistRow row);  // e.g., on goal updates
 };
@@ -0,0 +1,97 @@
+/*
+ * process-wide thread pool with priorities, and lock-free result queue
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+#include "utils.hpp"
+
+// tasks submitted and waited together, e.g., PIBT runs for one configuration
+struct TaskGroup {
+  int num_pending;  // guarded by the executor
+
+  TaskGroup();
+};
+
+// dequeued first by workers; waiting threads only run their own groups
+enum TaskPriority { PRIORITY_HIGH = 0, PRIORITY_LOW = 1 };
+
+struct Executor {
+  struct Task {
+    std::function<void()> fn;
+    TaskGroup *group;
+  };
+
+  // total thread budget of the process including the thread calling wait(),
+  // 0 -> hardware concurrency (at least two); see also set_num_threads
+  static int NUM_THREADS;
+
+  std::vector<std::thread> threads;
+  std::array<std::deque<Task>, 2> queues;  // for each priority
+  std::mutex mtx;
+  std::condition_variable cv_task;  // for workers
+  std::condition_variable cv_done;  // for wait()
+  bool flg_stop;
+
+  Executor(const int num_threads);
+  ~Executor();  // remaining tasks are completed before joining
+  void submit(TaskGroup &group, std::function<void()> fn,
+              const TaskPriority priority = PRIORITY_LOW);
+  // run pending tasks of the group on this thread until all of them are done
+  void wait(TaskGroup &group);
+
+private:
+  bool pop(Task &task, const TaskGroup *group);  // nullptr -> any group
+  void run(Task &task);
+  void work();
+};
+
+// shared by all planners, created with NUM_THREADS - 1 workers on first use;
+// at least one worker, otherwise refiners, async SUO and other low-priority
+// tasks would run only when waited
+Executor *get_executor();
+
+// multi-producer, single-consumer Treiber stack; the consumer takes all
+template <typename T>
+struct ResultQueue {
+  struct Node {
+    T value;
+    Node *next;
+  };
+  std::atomic<Node *> head;
+
+  ResultQueue() : head(nullptr) {}
+  ~ResultQueue() { pop_all(); }
+
+  void push(T value)
+  {
+    auto node = new Node{std::move(value), nullptr};
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+  // in order of push
+  std::vector<T> pop_all()
+  {
+    std::vector<T> res;
+    auto node = head.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      res.push_back(std::move(node->value));
+      auto next = node->next;
+      delete node;
+      node = next;
+    }
+    std::reverse(res.begin(), res.end());
+    return res;
+  }
+};
@@ -14,27 +14,36 @@ struct CompareHNodePointers {  // for determinism
 };
 
 struct HNode {
-  static int COUNT;
-
   const Config C;
   HNode *parent;
   std::set<HNode *, CompareHNodePointers> neighbor;
 
-  // value
-  int g;
+  // value, read without locks by concurrent searchers
+  std::atomic<int> g;
   int h;
-  int f;
+  std::atomic<int> f;
+  std::atomic<int> depth;  // steps from the start node along parents
 
   // for low-level search
   std::vector<float> priorities;
   std::vector<int> order;
   std::queue<LNode *> search_tree;
+  std::mutex search_tree_mtx;
 
   HNode(Config _C, DistTable *D, HNode *_parent = nullptr, int _g = 0,
         int _h = 0);
   ~HNode();
 
-  LNode *get_next_lowlevel_node(std::mt19937 &MT);
+  // created low-level nodes are counted in num_lnodes
+  LNode *get_next_lowlevel_node(std::mt19937 &MT,
+                                std::atomic<int> &num_lnodes);
+
+  // priorities & order of agents in the low-level search, also used to
+  // predict those of a node before creating it
+  static void set_priorities(const Config &C, DistTable *D,
+                             const HNode *parent,
+                             std::vector<float> &priorities,
+                             std::vector<int> &order);
 };
 using HNodes = std::vector<HNode *>;
 
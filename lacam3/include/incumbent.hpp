@@ -0,0 +1,41 @@
+/*
+ * immutable snapshots of the incumbent solution, shared with refiners
+ */
+
+#pragma once
+
+#include "graph.hpp"
+#include "instance.hpp"
+#include "metrics.hpp"
+#include "translator.hpp"
+#include "utils.hpp"
+
+struct PlanDiff;
+
+struct Incumbent {
+  // unchanged paths are shared among snapshots
+  std::vector<std::shared_ptr<const Path>> paths;
+  int loss;  // sum of loss
+  int makespan;
+
+  Incumbent(const Solution &solution);
+  Incumbent(const Incumbent &base, const PlanDiff &diff);
+  Config get_config(const int t) const;
+  Solution get_solution() const;
+};
+using IncumbentPtr = std::shared_ptr<const Incumbent>;
+
+// changes of paths from a snapshot, made by refiners
+struct PlanDiff {
+  IncumbentPtr base;
+  std::vector<int> agents;
+  Paths paths;
+  int t_min;  // changed timesteps of configurations, inclusive
+  int t_max;
+  int loss_delta;
+
+  PlanDiff(IncumbentPtr _base = nullptr);
+  PlanDiff(IncumbentPtr _base, const Solution &solution);
+  void add(const int i, const Path &path);
+  bool empty() const;
+};
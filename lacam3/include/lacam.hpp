@@ -3,10 +3,25 @@
 #include "dist_table.hpp"
 #include "graph.hpp"
 #include "instance.hpp"
+#include "lifelong.hpp"
 #include "planner.hpp"
 #include "post_processing.hpp"
+#include "receding_horizon.hpp"
+#include "server.hpp"
+#include "session.hpp"
 #include "sipp.hpp"
 #include "utils.hpp"
 
+// stats of the planner are copied when given, D is computed when not given
 Solution solve(const Instance &ins, const int verbose = 0,
-               const Deadline *deadline = nullptr, int seed = 0);
+               const Deadline *deadline = nullptr, int seed = 0,
+               const PlannerOptions &options = PlannerOptions(),
+               PlannerStats *stats = nullptr, DistTable *D = nullptr);
+
+// K planners with diverse parameters run concurrently, sharing the incumbent
+Solution solve_portfolio(const Instance &ins, const int K,
+                         const int verbose = 0,
+                         const Deadline *deadline = nullptr, int seed = 0,
+                         const PlannerOptions &options = PlannerOptions(),
+                         PlannerStats *stats = nullptr,
+                         DistTable *D = nullptr);
@@ -0,0 +1,98 @@
+/*
+ * C ABI of the solver, built as a shared library (liblacam3.so)
+ *
+ * - locations are grid indexes, i.e., width * y + x, as int32
+ * - solutions are contiguous int32 buffers of T x N, row t = configuration t
+ * - sessions keep a map and its distances; they can be used from multiple
+ *   threads concurrently
+ * - fields of lacam3_options are only appended in later versions; the library
+ *   reads and writes only those covered by struct_size, i.e., the size the
+ *   caller was compiled with
+ */
+#ifndef LACAM3_H
+#define LACAM3_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LACAM3_API_VERSION 1
+
+/* the shared library exports only these functions */
+#if defined(__GNUC__)
+#define LACAM3_API __attribute__((visibility("default")))
+#else
+#define LACAM3_API
+#endif
+
+enum lacam3_status {
+  LACAM3_SUCCESS = 0,
+  LACAM3_FAILURE = 1,           /* no solution within the time limit */
+  LACAM3_INVALID = 2,           /* e.g., out of the map, or N <= 0 */
+  LACAM3_BUFFER_TOO_SMALL = 3,  /* only the prefix is written */
+};
+
+typedef struct lacam3_options {
+  int32_t struct_size; /* set by lacam3_options_init */
+  int32_t flg_star;    /* keep refining until the time limit */
+  int32_t flg_multi_thread;
+  int32_t pibt_num;
+  int32_t flg_scatter;
+  int32_t flg_refiner;
+  int32_t refiner_num;
+  double random_insert_prob1;
+  double random_insert_prob2;
+  double recursive_rate;
+} lacam3_options;
+
+typedef struct lacam3_session lacam3_session;
+typedef struct lacam3_solution lacam3_solution;
+
+LACAM3_API int32_t lacam3_api_version(void);
+/* defaults, struct_size is the size of the caller's lacam3_options */
+LACAM3_API void lacam3_options_init_sized(lacam3_options *options,
+                                          int32_t struct_size);
+#define lacam3_options_init(options) \
+  lacam3_options_init_sized((options), (int32_t)sizeof(lacam3_options))
+/* total solver threads of the process, effective before the first solve */
+LACAM3_API void lacam3_set_num_threads(int32_t num_threads);
+
+/* NULL if the map cannot be loaded; NULL options -> defaults */
+LACAM3_API lacam3_session *lacam3_session_create(
+    const char *map_filename, const lacam3_options *options);
+LACAM3_API void lacam3_session_destroy(lacam3_session *session);
+LACAM3_API int32_t lacam3_session_width(const lacam3_session *session);
+LACAM3_API int32_t lacam3_session_height(const lacam3_session *session);
+
+/* solver-owned buffer, released by lacam3_solution_free */
+LACAM3_API lacam3_solution *lacam3_solve(lacam3_session *session,
+                                         const int32_t *starts,
+                                         const int32_t *goals, int32_t N,
+                                         int32_t time_limit_ms, int32_t seed);
+LACAM3_API int32_t lacam3_solution_status(const lacam3_solution *solution);
+/* 0 if failed */
+LACAM3_API int32_t lacam3_solution_T(const lacam3_solution *solution);
+LACAM3_API int32_t lacam3_solution_N(const lacam3_solution *solution);
+LACAM3_API const int32_t *lacam3_solution_data(
+    const lacam3_solution *solution);
+LACAM3_API int32_t lacam3_solution_sum_of_loss(
+    const lacam3_solution *solution);
+LACAM3_API double lacam3_solution_comp_time_ms(
+    const lacam3_solution *solution);
+LACAM3_API void lacam3_solution_free(lacam3_solution *solution);
+
+/* caller-provided buffer of max_T x N; *T receives the full length even
+ * when only the first max_T configurations are written */
+LACAM3_API int32_t lacam3_solve_into(lacam3_session *session,
+                                     const int32_t *starts,
+                                     const int32_t *goals, int32_t N,
+                                     int32_t time_limit_ms, int32_t seed,
+                                     int32_t *buf, int32_t max_T, int32_t *T);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LACAM3_H */
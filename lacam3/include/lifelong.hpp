@@ -0,0 +1,50 @@
+/*
+ * lifelong MAPF, i.e., agents receive new goals while moving; planning is
+ * receding-horizon, distances of changed goals are computed in background
+ */
+#pragma once
+
+#include "dist_table.hpp"
+#include "executor.hpp"
+#include "instance.hpp"
+#include "planner.hpp"
+#include "receding_horizon.hpp"
+#include "utils.hpp"
+
+// distances to a requested goal, computed in background
+struct GoalUpdate {
+  int agent;
+  Vertex *goal;
+  DistRow row;
+};
+
+struct Lifelong {
+  const Instance *ins;           // graph & initial goals
+  const PlannerOptions options;  // windowed, i.e., horizon > 0, without SUO
+  const int verbose;
+  DistCache dist_cache;  // rows of past goals, e.g., of stations
+  DistTable *D;          // rows of goals
+  Config goals;          // used in planning
+  Config goals_requested;  // latest, differ from goals while computing rows
+  TaskGroup bfs_group;
+  ResultQueue<GoalUpdate> bfs_results;
+  Solution plan;  // latest one, starting from the configuration of a tick
+  int num_ticks;
+  int num_goal_updates;
+  int num_rows_computed;
+
+  Lifelong(const Instance *_ins, const PlannerOptions &_options,
+           const int _verbose = 0,
+           const size_t dist_cache_capacity = SIZE_MAX);
+  ~Lifelong();
+
+  // the agent keeps the previous goal in planning until the row is ready
+  void set_goal(const int i, Vertex *goal);
+  void apply_goal_updates();  // rows computed so far
+  void sync();                // waiting for all rows
+  int get_num_pending() const;
+
+  // at most horizon steps from C, C included; shorter when the budget is
+  // exhausted, empty when no step is found
+  Solution tick(const Config &C, const Deadline *deadline, int seed = 0);
+};
@@ -7,8 +7,6 @@
 
 // low-level search node
 struct LNode {
-  static int COUNT;
-
   std::vector<int> who;
   Vertices where;
   const int depth;
@@ -34,6 +34,7 @@ struct PIBT {
 
   // scatter
   Scatter *scatter;
+  std::shared_ptr<const ScatterData> scatter_data;  // snapshot of the call
 
   PIBT(const Instance *_ins, DistTable *_D, int seed = 0, bool _flg_swap = true,
        Scatter *_scatter = nullptr);
@@ -17,16 +17,39 @@
 #pragma once
 
 #include "dist_table.hpp"
+#include "executor.hpp"
 #include "graph.hpp"
 #include "heuristic.hpp"
 #include "hnode.hpp"
+#include "incumbent.hpp"
 #include "instance.hpp"
 #include "pibt.hpp"
+#include "planner_options.hpp"
+#include "portfolio.hpp"
 #include "refiner.hpp"
 #include "scatter.hpp"
 #include "translator.hpp"
 #include "utils.hpp"
 
+// successors generated in advance for the node predicted to be expanded next,
+// i.e., the one just generated or found, with its next low-level node
+struct Speculation {
+  Config C;
+  std::vector<float> priorities;
+  std::vector<int> order;
+  std::vector<int> who;  // constraints of the low-level node
+  Vertices where;
+  std::vector<Config> Q_cands;  // worker-id -> configuration
+  std::vector<int> f_vals;
+  TaskGroup group;
+  std::atomic<bool> flg_cancelled;  // not-yet-started tasks are skipped
+  bool flg_active;                  // launched, neither used nor discarded
+  int num_hits;
+  int num_misses;
+
+  Speculation();
+};
+
 struct Planner {
   const Instance *ins;
   const Deadline *deadline;
@@ -46,64 +69,97 @@ struct Planner {
 
   // scatter (SUO)
   Scatter *scatter;
+  bool delete_scatter_after_used;  // false when given by the caller
+  Deadline *scatter_deadline;
+  TaskGroup scatter_group;  // used with async SUO
 
   // configuration generator
+  std::atomic<int> pibt_num;  // in use, 1 before the initial solution in
+                              // fast-first mode
   std::vector<PIBT *> pibts;
+  std::vector<PIBT *> pibts_spec;  // used in pipelined mode
+  Speculation spec;
 
   // for refiner
   int seed_refiner;
-  std::list<std::future<Solution>> refiner_pool;
+  TaskGroup refiner_group;
+  ResultQueue<PlanDiff> refiner_results;
+  int refiner_running;  // submitted but not incorporated yet
+  CancelToken refiner_cancel;
+  Deadline *refiner_deadline;  // cancellable, used in refiners
+  IncumbentPtr incumbent;      // snapshot shared with refiners
+  std::mutex refiner_mtx;
+  std::vector<RefinerSession *> refiner_sessions;  // idle ones
 
   // for search utils
   std::deque<HNode *> OPEN;
   std::unordered_map<Config, HNode *, ConfigHasher> EXPLORED;
   HNode *H_init;  // start node
   HNode *H_goal;  // goal node
+  Solution warm_start;  // from the starts, inserted before the search
+
+  // for concurrent searchers, the first one is on the calling thread
+  std::mutex graph_mtx;       // EXPLORED, neighbors & parents of HNodes, H_goal
+  std::atomic<int> f_bound;   // f-value of H_goal, INT_MAX before found
+  std::atomic<bool> flg_search_stop;
+
+  // parameters & statistics, owned by each planner
+  const PlannerOptions options;
+  PlannerStats stats;
+
+  // for portfolio
+  Portfolio *portfolio;
+  int portfolio_id;
+  IncumbentPtr portfolio_seen;  // last one published or taken
+
+  IncumbentPtr reported;  // last one passed to options.on_improvement
 
-  // parameters
-  static bool FLG_SWAP;  // whether to use swap technique in PIBT
-  static bool
-      FLG_STAR;  // whether to refine solutions after initial solution discovery
-  static bool FLG_MULTI_THREAD;
-  static int SCATTER_MARGIN;  // used in SUO
-  static int PIBT_NUM;  // number of PIBT run, i.e., Monte-Carlo configuration
-                        // generator
-  static bool FLG_REFINER;  // whether to use refiners
-  static int REFINER_NUM;   // number of refiners
-  static bool
-      FLG_SCATTER;  // whether to use space utilization optimization (SUO)
-  static float RANDOM_INSERT_PROB1;  // inserting the start node
-  static float RANDOM_INSERT_PROB2;  // inserting a node after finding the goal
-  static bool FLG_RANDOM_INSERT_INIT_NODE;
-  static float RECURSIVE_RATE;
-  static double RECURSIVE_TIME_LIMIT;
-
-  // for logging
-  static int CHECKPOINTS_DURATION;
-  static std::string MSG;
-
-  int search_iter;
-  int time_initial_solution;
-  int cost_initial_solution;
-  std::vector<int> checkpoints;
+  // main search is favored over refiners and recursive planners
+  const TaskPriority priority;
 
   Planner(const Instance *_ins, int _verbose = 0,
           const Deadline *_deadline = nullptr, int _seed = 0,
-          int _depth = 0,          // used in recursive LaCAM
-          DistTable *_D = nullptr  // used in recursive LaCAM
-  );
+          int _depth = 0,           // used in recursive LaCAM
+          DistTable *_D = nullptr,  // used in recursive LaCAM
+          const PlannerOptions &_options = PlannerOptions());
   ~Planner();
   Solution solve();
+  void search_parallel();
+  int search(const int id, std::deque<HNode *> &open,
+             std::vector<PIBT *> &generators);
   bool set_new_config(HNode *S, LNode *M, Config &Q_to);
+  bool set_new_config(HNode *H, LNode *L, Config &Q_to,
+                      std::vector<PIBT *> &generators);
+  bool get_best_config(const std::vector<Config> &Q_cands,
+                       const std::vector<int> &f_vals, Config &Q_to);
+  void speculate(HNode *H, const Config &Q);
+  void speculate(HNode *H);
+  void launch_speculation();
+  bool use_speculation(HNode *H, LNode *L);
+  void clear_speculation();
   HNode *create_highlevel_node(const Config &Q, HNode *parent);
-  void rewrite(HNode *H_from, HNode *H_to);
+  bool is_goal(const HNode *H);
+  HNode *get_deepest_node();
+  void rewrite(HNode *H_from, HNode *H_to, std::deque<HNode *> &open);
   int get_edge_cost(const Config &C1, const Config &C2);
   Solution backtrack(HNode *H);
   void apply_new_solution(const Solution &plan);
+  void apply_new_solution(const PlanDiff &diff);
+  HNode *insert_config(HNode *H_from, const Config &Q);
+  IncumbentPtr get_incumbent();
   void set_scatter();
+  void launch_scatter();
+  void clear_scatter();
+  void enable_extras();
   void set_pibt();
   void set_refiner();
-  Solution get_refined_plan(const Solution &plan_origin);
+  void launch_refiner(IncumbentPtr base);
+  void clear_refiner();
+  PlanDiff get_refined_plan(IncumbentPtr base, const int seed);
+  RefinerSession *acquire_refiner_session(const int seed);
+  void release_refiner_session(RefinerSession *session);
+  void sync_portfolio();
+  void report_improvement();
   void update_checkpoints();
   void logging();
 };
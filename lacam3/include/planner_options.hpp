@@ -0,0 +1,66 @@
+/*
+ * parameters and statistics of one planner, so that several planners with
+ * different settings can run in one process
+ */
+
+#pragma once
+
+#include "executor.hpp"
+#include "incumbent.hpp"
+#include "utils.hpp"
+
+// improved solution and elapsed time (ms), called on the search thread
+using ImprovementCallback = std::function<void(IncumbentPtr, double)>;
+
+struct PlannerOptions {
+  bool flg_swap = true;  // whether to use swap technique in PIBT
+  bool flg_star = true;  // whether to refine solutions after initial solution
+                         // discovery
+  bool flg_fast_first = false;  // single PIBT without SUO until the initial
+                                // solution, then all enabled extras
+  bool flg_multi_thread = true;
+  int scatter_margin = 10;  // used in SUO, negative -> random in [0, 30]
+  int pibt_num = 10;  // number of PIBT run, i.e., Monte-Carlo configuration
+                      // generator
+  bool flg_pipeline = false;  // speculative expansion during bookkeeping
+  int searcher_num = 1;       // concurrent high-level searchers
+  int portfolio_num = 1;      // planners with diverse parameters, used in solve
+  bool flg_refiner = true;            // whether to use refiners
+  int refiner_num = 4;                // number of refiners
+  int refiner_threads = 1;            // cooperative threads in each refiner
+  bool flg_refiner_adaptive = false;  // learning neighborhoods in refiners
+  float repair_rate = 0;              // PIBT-based repair in refiners, 0: off
+  bool flg_scatter = true;  // whether to use space utilization optimization
+  bool flg_scatter_async = false;  // computing SUO concurrently with search
+  int scatter_threads = 1;         // parallel path construction in SUO
+  float random_insert_prob1 = 0.1;   // inserting the start node
+  float random_insert_prob2 = 0.01;  // inserting a node after finding the goal
+  bool flg_random_insert_init_node = false;
+  float recursive_rate = 0.2;
+  double recursive_time_limit = 1000;  // ms
+  int horizon = 0;  // >0 -> windowed planning, nodes at this depth are goals
+  bool flg_horizon_progress = false;  // windowed, nodes where all agents get
+                                      // closer to their goals are also goals
+  int checkpoints_duration = 5000;     // ms, for logging
+  ImprovementCallback on_improvement;  // anytime output, optional
+};
+
+// counters are updated by concurrent searchers and refiners
+struct PlannerStats {
+  std::atomic<int> num_high_level_nodes;
+  std::atomic<int> num_low_level_nodes;
+  int search_iter;
+  int time_initial_solution;
+  int cost_initial_solution;
+  std::vector<int> checkpoints;  // f-value of the goal node, -1 before found
+
+  PlannerStats();
+  PlannerStats(const PlannerStats &other);
+  PlannerStats &operator=(const PlannerStats &other);
+  std::string get_msg() const;  // key=value lines, used in the log file
+};
+
+// budget of Executor::NUM_THREADS for planners with the options, before the
+// first use of the executor; num_threads <= 0 -> hardware concurrency, but at
+// least one thread for each refiner and one for the search
+void set_num_threads(const int num_threads, const PlannerOptions &options);
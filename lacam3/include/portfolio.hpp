@@ -0,0 +1,19 @@
+/*
+ * planners with diverse parameters, sharing the incumbent in one process
+ */
+
+#pragma once
+
+#include "incumbent.hpp"
+#include "utils.hpp"
+
+struct Portfolio {
+  std::mutex mtx;
+  IncumbentPtr incumbent;  // best solution among members
+  int source;              // member that found the incumbent
+  CancelToken cancel;  // cancelled when a member completes, e.g., optimality
+
+  Portfolio(const Deadline *deadline = nullptr);
+  bool publish(IncumbentPtr solution, const int id);  // true if improved
+  IncumbentPtr get();
+};
@@ -5,6 +5,7 @@
 #include "dist_table.hpp"
 #include "instance.hpp"
 #include "metrics.hpp"
+#include "planner_options.hpp"
 #include "utils.hpp"
 
 bool is_feasible_solution(const Instance &ins, const Solution &solution,
@@ -15,5 +16,11 @@ void print_stats(const int verbose, const Deadline *deadline,
 void make_log(const Instance &ins, const Solution &solution,
               const std::string &output_name, const double comp_time_ms,
               const std::string &map_name, const int seed,
+              const PlannerStats &stats,
               const bool log_short = false  // true -> paths not appear
 );
+// one block per improved solution, in the format of make_log; with prev,
+// only changed paths are written
+void write_improvement(std::ostream &os, const Instance &ins,
+                       IncumbentPtr solution, IncumbentPtr prev,
+                       const double elapsed_ms);
@@ -0,0 +1,40 @@
+/*
+ * receding-horizon planning for real-time control, i.e., a plan of the next
+ * steps is computed at every control tick within the budget of the tick,
+ * reusing distances, SUO and the previous plan
+ */
+#pragma once
+
+#include "dist_table.hpp"
+#include "instance.hpp"
+#include "planner.hpp"
+#include "scatter.hpp"
+#include "utils.hpp"
+
+// plan at most horizon steps from C towards the goals, warm-started by the
+// rest of the previous plan when C is on it; plan is replaced by the new one,
+// returns the number of reused steps
+int plan_horizon(Graph *G, const Config &C, const Config &goals, DistTable *D,
+                 Scatter *scatter, const PlannerOptions &options,
+                 const Deadline *deadline, const int seed, const int verbose,
+                 Solution &plan);
+
+struct RecedingHorizon {
+  const Instance *ins;  // goals, starts are only used for SUO
+  const PlannerOptions options;  // windowed, i.e., horizon > 0
+  const int verbose;
+  DistTable *D;
+  Scatter *scatter;  // computed once, from the starts
+  Solution plan;     // latest one, starting from the configuration of a tick
+  int num_ticks;
+
+  // SUO is constructed within setup_deadline when enabled
+  RecedingHorizon(const Instance *_ins, const PlannerOptions &_options,
+                  const int _verbose = 0,
+                  const Deadline *setup_deadline = nullptr);
+  ~RecedingHorizon();
+
+  // at most horizon steps from C, C included; shorter when the budget is
+  // exhausted, empty when no step is found
+  Solution tick(const Config &C, const Deadline *deadline, int seed = 0);
+};
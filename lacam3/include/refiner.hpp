@@ -17,13 +17,122 @@
 
 #include "collision_table.hpp"
 #include "dist_table.hpp"
+#include "executor.hpp"
 #include "graph.hpp"
+#include "incumbent.hpp"
 #include "instance.hpp"
 #include "metrics.hpp"
+#include "pibt.hpp"
 #include "sipp.hpp"
 #include "translator.hpp"
 #include "utils.hpp"
 
+// roulette wheel selection with exponentially smoothed rewards, as in ALNS
+struct Bandit {
+  std::vector<double> weights;
+  const double reaction;
+
+  Bandit(const int num_arms, const double _reaction = 0.1);
+  int select(std::mt19937 &MT) const;
+  void update(const int arm, const double reward);
+};
+
+struct Neighborhood {
+  std::vector<int> agents;
+  int generator;  // -1 -> chunk of a random order
+  int size_arm;
+};
+
+// long-lived state of a refiner, i.e., paths & collision table, updated by
+// diffs of the incumbent so that each round only costs its neighborhoods
+struct RefinerSession {
+  const Instance *ins;
+  DistTable *D;
+  const int N;
+  std::mt19937 MT;
+  const int verbose;
+
+  Paths paths;  // synced with the incumbent
+  // agent -> path of the last synced snapshot, nullptr if modified since
+  std::vector<std::shared_ptr<const Path>> synced;
+  CollisionTable CT;
+  SIPPContext ctx;
+  std::vector<int> order;
+  Paths old_paths;  // buffer for replan
+
+  // cooperative LNS; workers replan disjoint neighborhoods on their own
+  // replicas, then this session validates & commits them one by one
+  std::vector<RefinerSession *> workers;
+  int num_commits;
+  int num_rejects;
+  static constexpr int REGION_CELL_SIZE = 4;
+  static constexpr int REGION_TIME_SIZE = 8;
+
+  // adaptive neighborhood selection, learning improvement per ms
+  const bool flg_adaptive;
+  std::vector<Neighborhood> neighborhoods;
+  Bandit bandit_generator;
+  Bandit bandit_size;
+  std::vector<std::vector<int>> goal_agents;  // vertex -> agents
+  std::vector<int> intersections;             // vertices with degree >= 3
+  std::vector<int> agent_stamps;              // used in generators
+  std::vector<int> vertex_stamps;
+  int stamp;
+  static constexpr int NB_RANDOM = 0;
+  static constexpr int NB_AGENT = 1;         // agents interacting in CT
+  static constexpr int NB_INTERSECTION = 2;  // agents around an intersection
+  static constexpr int NB_GENERATORS = 3;
+  static constexpr std::array<int, 5> NB_SIZES = {2, 4, 8, 16, 32};
+
+  // whether the last pass of refine() improved nothing
+  bool flg_stalled;
+  static constexpr int REPAIR_WINDOW_MIN = 8;
+  static constexpr int REPAIR_WINDOW_MAX = 32;
+  static constexpr int REPAIR_TRIALS = 3;
+
+  RefinerSession(const Instance *_ins, DistTable *_D, const int seed = 0,
+                 const int _verbose = 0, const int num_threads = 1,
+                 const bool _flg_adaptive = false);
+  ~RefinerSession();
+
+  // apply the incumbent, returns the number of replaced paths
+  int sync(const Solution &solution);
+  // apply changes of the snapshot, O(N) pointer checks + changed paths
+  int sync(const Incumbent &incumbent);
+  // changes of the agents from the snapshot
+  PlanDiff get_diff(IncumbentPtr base, const std::vector<int> &agents) const;
+  // apply paths of the specified agents, returns the number of replaced paths
+  int sync(const Paths &_paths, const std::vector<int> &agents);
+  // one pass of LNS, returns agents whose paths are improved
+  std::vector<int> refine(const Deadline *deadline, const int id = 0);
+  // re-solve a time window with PIBT while keeping boundary configurations,
+  // cheap when SIPP stalls in dense cases; returns agents whose paths change
+  std::vector<int> repair(const Deadline *deadline, const int id = 0,
+                          const TaskPriority priority = PRIORITY_LOW);
+  // replan agents with SIPP and keep the result if not worse,
+  // returns decrease of loss, -1 if rejected; old paths remain in old_paths
+  int replan(const std::vector<int> &agents, const Deadline *deadline);
+  // replace paths of agents if collision-free
+  bool commit(const std::vector<int> &agents, const Paths &new_paths);
+  Solution get_solution() const;
+
+private:
+  void apply(const Solution &solution, std::vector<int> &updated);
+  std::vector<int> refine_sequential(const Deadline *deadline, const int id);
+  std::vector<int> refine_parallel(const Deadline *deadline, const int id);
+  void set_neighborhoods(const Deadline *deadline, const int id);
+  void reward(const Neighborhood &nb, const int delta, const double time_ms);
+  void get_random_neighborhood(const int size, std::vector<int> &agents);
+  void get_agent_neighborhood(const int size, std::vector<int> &agents);
+  void get_intersection_neighborhood(const int size, std::vector<int> &agents);
+  bool add_agent(const int i, const int size, std::vector<int> &agents);
+  void set_path(const int i, const Path &path);
+  // coarse space-time cells touched by agent-i, staying at goal included
+  void get_region(const int i, const int T, std::vector<uint64_t> &cells) const;
+};
+
+std::ostream &operator<<(std::ostream &os, const Bandit &bandit);
+
 Solution refine(const Instance *ins, const Deadline *deadline,
                 const Solution &solution, DistTable *D, const int seed = 0,
                 const int verbose = 0);
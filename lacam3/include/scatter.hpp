@@ -11,9 +11,22 @@
 
 #include "collision_table.hpp"
 #include "dist_table.hpp"
+#include "executor.hpp"
 #include "graph.hpp"
 #include "utils.hpp"
 
+// flat lookup of SUO outcome, agent & vertex-id -> next vertex
+struct ScatterData {
+  // entries of agent-i are [offsets[i], offsets[i+1]), sorted by vertex-id
+  std::vector<int> offsets;
+  std::vector<int> keys;  // vertex-id, separated for cache-friendly search
+  std::vector<Vertex *> values;  // next vertex
+
+  ScatterData(const std::vector<Path> &paths);
+  Vertex *get(const int i, const int v_id) const;  // nullptr if not found
+  size_t memory_usage() const;                     // bytes
+};
+
 struct Scatter {
   const Instance *ins;
   const Deadline *deadline;
@@ -25,17 +38,36 @@ struct Scatter {
   DistTable *D;
   const int cost_margin;
   int sum_of_path_length;
+  const bool flg_async;  // publish every iteration, used with background run
+  const int num_threads;  // >1 -> batched parallel path construction
+  int num_replans;        // replanning caused by racing commits
+  std::atomic<bool> flg_stop;
+
+  // agents planned concurrently by each worker
+  static constexpr int BATCH_SIZE_PER_THREAD = 4;
 
   // outcome
   std::vector<Path> paths;
-  // agent, vertex-id, next vertex
-  std::vector<std::unordered_map<int, Vertex *>> scatter_data;
+  // snapshot read by PIBT, swapped atomically
+  std::shared_ptr<const ScatterData> scatter_data;
 
   // collision data
   CollisionTable CT;
 
   void construct();
+  void construct_sequential(const std::vector<int> &order,
+                            std::vector<Vertex *> &CLOSED);
+  void construct_parallel(const std::vector<int> &order,
+                          std::vector<std::vector<Vertex *>> &CLOSEDs);
+  int find_path(const int i, std::vector<Vertex *> &CLOSED, Path &path,
+                bool flg_ignore_self = false);
+  int get_collision_cost(const Path &path);
+  void publish();
+  std::shared_ptr<const ScatterData> get_scatter_data() const;
+  void stop();
+  bool is_stopped() const;
 
   Scatter(const Instance *_ins, DistTable *_D, const Deadline *_deadline,
-          const int seed = 0, int _verbose = 0, int _cost_margin = 2);
+          const int seed = 0, int _verbose = 0, int _cost_margin = 2,
+          bool _flg_async = false, int _num_threads = 1);
 };
@@ -0,0 +1,75 @@
+/*
+ * planning daemon over a Unix domain socket, keeping solver sessions of maps
+ *
+ * protocol: a connection carries any number of request/response pairs,
+ * all fields are int32 in native byte order
+ * - request:  MAGIC, map_id, N, time_limit_ms, seed, starts[N], goals[N]
+ * - response: MAGIC, status, comp_time_ms, T, N, solution[T][N]
+ * locations are indexes of the grid, i.e., width * y + x
+ */
+#pragma once
+
+#include <unistd.h>
+
+#include <condition_variable>
+
+#include "session.hpp"
+#include "utils.hpp"
+
+namespace protocol
+{
+constexpr int32_t MAGIC = 0x4C43414D;  // "LCAM"
+constexpr int32_t MAX_AGENTS = 1 << 20;
+
+enum Status : int32_t { SUCCESS = 0, FAILURE = 1, INVALID = 2 };
+
+struct Request {
+  int32_t map_id;
+  int32_t time_limit_ms;
+  int32_t seed;
+  std::vector<int32_t> starts;
+  std::vector<int32_t> goals;
+};
+
+struct Response {
+  int32_t status;
+  int32_t comp_time_ms;
+  std::vector<std::vector<int32_t>> solution;  // T x N
+};
+
+// false on closed connections or malformed frames
+bool read_request(int fd, Request &req);
+bool write_request(int fd, const Request &req);
+bool read_response(int fd, Response &res);
+bool write_response(int fd, const Response &res);
+
+int connect(const std::string &socket_path);  // -1 on failure
+}  // namespace protocol
+
+struct Server {
+  const std::string socket_path;
+  std::vector<SolverSession *> sessions;  // map_id -> session, not owned
+  const int verbose;
+  const int max_time_limit_ms;  // time limits of requests are capped
+  int listen_fd;
+  std::atomic<bool> flg_stop;
+  CancelToken cancel;  // cancelled on stop, running requests return soon
+
+  // one detached thread per connection, serving its requests in order
+  std::mutex mtx;
+  std::condition_variable cv_closed;
+  std::unordered_set<int> client_fds;
+
+  Server(const std::string &_socket_path,
+         const std::vector<SolverSession *> &_sessions, const int _verbose = 0,
+         const int _max_time_limit_ms = 60000);
+  ~Server();
+
+  bool open();  // bind & listen, replacing a stale socket file
+  void run();   // accept loop until stop(), then waits for connections
+  void stop();  // async-signal-safe
+  protocol::Response handle(const protocol::Request &req);
+
+private:
+  void serve(int fd);
+};
@@ -0,0 +1,38 @@
+/*
+ * solver session for a stream of instances on one map, keeping the graph and
+ * BFS distances across requests
+ */
+#pragma once
+
+#include "dist_table.hpp"
+#include "graph.hpp"
+#include "instance.hpp"
+#include "planner_options.hpp"
+#include "utils.hpp"
+
+struct SolverSession {
+  Graph *G;
+  DistCache dist_cache;
+  const PlannerOptions options;
+  const int verbose;
+  std::atomic<int> num_requests;
+
+  SolverSession(const std::string &map_filename,
+                const PlannerOptions &_options = PlannerOptions(),
+                const int _verbose = 0,
+                const size_t dist_cache_capacity = SIZE_MAX);
+  ~SolverSession();
+
+  // starts & goals are indexes of G->U, i.e., width * y + x; safe to call
+  // from multiple threads; empty solution for invalid or unsolved requests
+  Solution solve(const std::vector<int> &start_indexes,
+                 const std::vector<int> &goal_indexes,
+                 const Deadline *deadline = nullptr, int seed = 0,
+                 PlannerStats *stats = nullptr);
+  Solution solve(const Config &starts, const Config &goals,
+                 const Deadline *deadline = nullptr, int seed = 0,
+                 PlannerStats *stats = nullptr);
+  Vertex *get_vertex(const int index) const;  // nullptr if not on G
+  // non-empty, on G, of the same size, and distinct in each configuration
+  bool is_valid(const Config &starts, const Config &goals) const;
+};
@@ -15,41 +15,58 @@
 #include "graph.hpp"
 #include "utils.hpp"
 
-// safe interval
-using SI = std::pair<int, int>;
-using SIs = std::vector<SI>;
-
-struct SITable {
-  std::unordered_map<int, SIs> body;
-  CollisionTable *CT;
-
-  SITable(CollisionTable *_CT);
-  ~SITable();
-  SIs &get(Vertex *v);
-};
+// note: safe intervals are maintained by CollisionTable
 
 struct SINode {
-  const int uuid;
+  const int uuid;  // index in the arena
   const int time_start;
   const int time_end;
   Vertex *v;
   const int t;  // arrival time
   const int g;
   const int f;
-  SINode *parent;
+  const int parent;  // index in the arena, -1 for the start
 
   SINode(const int uuid, const SI &si, Vertex *_v, int _t, int _g, int _f,
-         SINode *_parent);
-  bool operator==(const SINode &other) const;
+         int _parent);
 };
-using SINodes = std::vector<SINode *>;
 
-struct SINodeHasher {
-  uint operator()(const SINode &n) const;
+// reusable search memory of SIPP, one for each thread
+struct SIPPContext {
+  // search state for (vertex, safe interval)
+  struct State {
+    int node;      // best node so far
+    int heap_pos;  // -1 -> not in OPEN
+  };
+  struct Slot {
+    uint64_t key;
+    int state;
+    uint32_t stamp;  // valid only if equal to the current stamp
+  };
+
+  std::vector<SINode> nodes;  // arena, cleared for each call
+  std::vector<State> states;
+  std::vector<Slot> table;  // closed list, open addressing
+  std::vector<int> heap;    // OPEN, state-id, with decrease-key
+  uint32_t stamp;
+
+  SIPPContext();
+  void reset();
+  int get_state(const uint64_t key);  // -1 if not found
+  int add_state(const uint64_t key, const int node);
+  void push(const int s);
+  int pop();
+  void update(const int s);  // priority of s increased
+
+private:
+  bool is_prior(const int s1, const int s2) const;
+  void sift_up(int k);
+  void sift_down(int k);
+  void grow();
 };
 
 Path sipp(const int i, Vertex *s_i, Vertex *g_i, DistTable *D,
           CollisionTable *CT, const Deadline *deadline = nullptr,
-          const int f_upper_bound = INT_MAX);
+          const int f_upper_bound = INT_MAX, SIPPContext *ctx = nullptr);
 
 std::ostream &operator<<(std::ostream &os, const SINode *n);
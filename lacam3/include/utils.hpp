@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <climits>
 #include <fstream>
@@ -13,24 +14,42 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <queue>
 #include <random>
 #include <regex>
 #include <set>
+#include <sstream>
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using Time = std::chrono::steady_clock;
 
-// time manager
+// cooperative cancellation, cancelling a parent cancels its descendants
+struct CancelToken {
+  std::atomic<bool> flg_cancelled;
+  const CancelToken *parent;
+
+  CancelToken(const CancelToken *_parent = nullptr);
+  void cancel();
+  bool is_cancelled() const;
+};
+
+// time manager, also expires when its token is cancelled
 struct Deadline {
   const Time::time_point t_s;
   const double time_limit_ms;
+  const CancelToken *cancel_token;
 
-  Deadline(double _time_limit_ms = 0);
+  Deadline(double _time_limit_ms = 0,
+           const CancelToken *_cancel_token = nullptr);
+  // same time limit as the base, with another token
+  Deadline(const Deadline *base, const CancelToken *_cancel_token);
   double elapsed_ms() const;
   double elapsed_ns() const;
 };
@@ -62,8 +81,10 @@ void info(const int level, const int verbose, const Deadline *deadline,
           Body &&...body)
 {
   if (verbose < level) return;
-  std::cout << "elapsed:" << std::setw(6) << elapsed_ms(deadline) << "ms  ";
-  info(level, verbose, (body)...);
+  // formatted apart from std::cout, which is shared by concurrent solvers
+  std::stringstream ss;
+  ss << "elapsed:" << std::setw(6) << elapsed_ms(deadline) << "ms  ";
+  info(level, verbose, ss.str(), (body)...);
 }
 
 std::ostream &operator<<(std::ostream &os, const std::vector<int> &arr);
@@ -0,0 +1,231 @@
+#include "../include/lacam3.h"
+
+#include <cstddef>
+
+#include "../include/lacam.hpp"
+
+struct lacam3_session {
+  SolverSession session;
+};
+
+struct lacam3_solution {
+  int32_t status;
+  int32_t T;
+  int32_t N;
+  std::vector<int32_t> data;  // T x N
+  int32_t sum_of_loss;
+  double comp_time_ms;
+};
+
+// fields within the struct of the caller, compiled with an older header
+#define HAS_FIELD(options, field)                     \
+  ((options)->struct_size >= 0 &&                     \
+   (size_t)(options)->struct_size >=                  \
+       offsetof(lacam3_options, field) + sizeof((options)->field))
+
+static PlannerOptions get_options(const lacam3_options *options)
+{
+  auto res = PlannerOptions();
+  if (options == nullptr || !HAS_FIELD(options, struct_size)) return res;
+  if (HAS_FIELD(options, flg_star)) res.flg_star = options->flg_star;
+  if (HAS_FIELD(options, flg_multi_thread)) {
+    res.flg_multi_thread = options->flg_multi_thread;
+  }
+  if (HAS_FIELD(options, pibt_num)) res.pibt_num = options->pibt_num;
+  if (HAS_FIELD(options, flg_scatter)) res.flg_scatter = options->flg_scatter;
+  if (HAS_FIELD(options, flg_refiner)) res.flg_refiner = options->flg_refiner;
+  if (HAS_FIELD(options, refiner_num)) res.refiner_num = options->refiner_num;
+  if (HAS_FIELD(options, random_insert_prob1)) {
+    res.random_insert_prob1 = options->random_insert_prob1;
+  }
+  if (HAS_FIELD(options, random_insert_prob2)) {
+    res.random_insert_prob2 = options->random_insert_prob2;
+  }
+  if (HAS_FIELD(options, recursive_rate)) {
+    res.recursive_rate = options->recursive_rate;
+  }
+  return res;
+}
+
+static int32_t solve(lacam3_session *session, const int32_t *starts,
+                     const int32_t *goals, int32_t N, int32_t time_limit_ms,
+                     int32_t seed, Solution &solution, double &comp_time_ms)
+{
+  if (session == nullptr || N <= 0 || time_limit_ms <= 0 ||
+      starts == nullptr || goals == nullptr) {
+    return LACAM3_INVALID;
+  }
+  auto &s = session->session;
+  auto C_starts = Config(N, nullptr);
+  auto C_goals = Config(N, nullptr);
+  for (auto i = 0; i < N; ++i) {
+    C_starts[i] = s.get_vertex(starts[i]);
+    C_goals[i] = s.get_vertex(goals[i]);
+  }
+  if (!s.is_valid(C_starts, C_goals)) return LACAM3_INVALID;
+  const auto deadline = Deadline(time_limit_ms);
+  solution = s.solve(C_starts, C_goals, &deadline, seed);
+  comp_time_ms = deadline.elapsed_ms();
+  return solution.empty() ? LACAM3_FAILURE : LACAM3_SUCCESS;
+}
+
+// first max_T configurations
+static void write(const Solution &solution, int32_t *buf, const size_t max_T)
+{
+  const auto T = std::min(solution.size(), max_T);
+  for (size_t t = 0; t < T; ++t) {
+    const auto &Q = solution[t];
+    for (size_t i = 0; i < Q.size(); ++i) buf[t * Q.size() + i] = Q[i]->index;
+  }
+}
+
+extern "C" {
+
+int32_t lacam3_api_version(void) { return LACAM3_API_VERSION; }
+
+void lacam3_options_init_sized(lacam3_options *options, int32_t struct_size)
+{
+  if (options == nullptr) return;
+  options->struct_size = struct_size;
+  if (!HAS_FIELD(options, struct_size)) return;
+  const auto defaults = PlannerOptions();
+  if (HAS_FIELD(options, flg_star)) options->flg_star = defaults.flg_star;
+  if (HAS_FIELD(options, flg_multi_thread)) {
+    options->flg_multi_thread = defaults.flg_multi_thread;
+  }
+  if (HAS_FIELD(options, pibt_num)) options->pibt_num = defaults.pibt_num;
+  if (HAS_FIELD(options, flg_scatter)) {
+    options->flg_scatter = defaults.flg_scatter;
+  }
+  if (HAS_FIELD(options, flg_refiner)) {
+    options->flg_refiner = defaults.flg_refiner;
+  }
+  if (HAS_FIELD(options, refiner_num)) {
+    options->refiner_num = defaults.refiner_num;
+  }
+  if (HAS_FIELD(options, random_insert_prob1)) {
+    options->random_insert_prob1 = defaults.random_insert_prob1;
+  }
+  if (HAS_FIELD(options, random_insert_prob2)) {
+    options->random_insert_prob2 = defaults.random_insert_prob2;
+  }
+  if (HAS_FIELD(options, recursive_rate)) {
+    options->recursive_rate = defaults.recursive_rate;
+  }
+}
+
+void lacam3_set_num_threads(int32_t num_threads)
+{
+  Executor::NUM_THREADS = num_threads;
+}
+
+lacam3_session *lacam3_session_create(const char *map_filename,
+                                      const lacam3_options *options)
+{
+  if (map_filename == nullptr) return nullptr;
+  try {
+    const auto planner_options = get_options(options);
+    // default budget, effective before the first solve; a budget given by the
+    // caller is kept, single-threaded sessions rely on flg_multi_thread
+    if (Executor::NUM_THREADS <= 0) {
+      auto options_default = planner_options;
+      options_default.flg_multi_thread = true;
+      set_num_threads(0, options_default);
+    }
+    auto session =
+        new lacam3_session{SolverSession(map_filename, planner_options)};
+    if (session->session.G->size() > 0) return session;
+    delete session;
+  } catch (const std::exception &) {
+  }
+  return nullptr;
+}
+
+void lacam3_session_destroy(lacam3_session *session) { delete session; }
+
+int32_t lacam3_session_width(const lacam3_session *session)
+{
+  return session->session.G->width;
+}
+
+int32_t lacam3_session_height(const lacam3_session *session)
+{
+  return session->session.G->height;
+}
+
+lacam3_solution *lacam3_solve(lacam3_session *session, const int32_t *starts,
+                              const int32_t *goals, int32_t N,
+                              int32_t time_limit_ms, int32_t seed)
+{
+  try {
+    auto res = new lacam3_solution{LACAM3_INVALID, 0, N, {}, 0, 0};
+    auto solution = Solution();
+    res->status = solve(session, starts, goals, N, time_limit_ms, seed,
+                        solution, res->comp_time_ms);
+    if (res->status != LACAM3_SUCCESS) return res;
+    res->T = solution.size();
+    res->data.resize(solution.size() * N);
+    write(solution, res->data.data(), solution.size());
+    res->sum_of_loss = get_sum_of_loss(solution);
+    return res;
+  } catch (const std::exception &) {
+    return nullptr;
+  }
+}
+
+int32_t lacam3_solution_status(const lacam3_solution *solution)
+{
+  return solution->status;
+}
+
+int32_t lacam3_solution_T(const lacam3_solution *solution)
+{
+  return solution->T;
+}
+
+int32_t lacam3_solution_N(const lacam3_solution *solution)
+{
+  return solution->N;
+}
+
+const int32_t *lacam3_solution_data(const lacam3_solution *solution)
+{
+  return solution->data.data();
+}
+
+int32_t lacam3_solution_sum_of_loss(const lacam3_solution *solution)
+{
+  return solution->sum_of_loss;
+}
+
+double lacam3_solution_comp_time_ms(const lacam3_solution *solution)
+{
+  return solution->comp_time_ms;
+}
+
+void lacam3_solution_free(lacam3_solution *solution) { delete solution; }
+
+int32_t lacam3_solve_into(lacam3_session *session, const int32_t *starts,
+                          const int32_t *goals, int32_t N,
+                          int32_t time_limit_ms, int32_t seed, int32_t *buf,
+                          int32_t max_T, int32_t *T)
+{
+  if (T != nullptr) *T = 0;
+  if (T == nullptr || max_T < 0 || (buf == nullptr && max_T > 0)) {
+    return LACAM3_INVALID;
+  }
+  try {
+    auto solution = Solution();
+    auto comp_time_ms = 0.0;
+    const auto status = solve(session, starts, goals, N, time_limit_ms, seed,
+                              solution, comp_time_ms);
+    if (status != LACAM3_SUCCESS) return status;
+    *T = solution.size();
+    write(solution, buf, max_T);
+    return *T > max_T ? LACAM3_BUFFER_TOO_SMALL : LACAM3_SUCCESS;
+  } catch (const std::exception &) {
+    return LACAM3_FAILURE;
+  }
+}
+
+}  // extern "C"
@@ -1,8 +1,16 @@
 #include "../include/collision_table.hpp"
 
+CollisionCell::CollisionCell() : cnt(0), agents() {}
+
+static const SI FULL_INTERVAL = SI(0, CollisionTable::TIME_INF);
+
 CollisionTable::CollisionTable(const Instance *ins)
     : body(ins->G->size()),
+      overflow(),
       body_last(ins->G->size()),
+      body_last_agent(ins->N, std::make_pair(-1, -1)),
+      safe_intervals(ins->G->size()),
+      moves(ins->G->size()),
       collision_cnt(0),
       N(ins->N)
 {
@@ -11,25 +19,36 @@ CollisionTable::CollisionTable(const Instance *ins)
 CollisionTable::~CollisionTable() {}
 
 int CollisionTable::getCollisionCost(const Vertex *v_from, const Vertex *v_to,
-                                     const int t_from)
+                                     const int t_from, const int i)
 {
   const int t_to = t_from + 1;
   auto collision = 0;
   // vertex collision
-  if (t_to < body[v_to->id].size()) {
-    collision += body[v_to->id][t_to].size();
+  if (t_to < (int)body[v_to->id].size()) {
+    collision += body[v_to->id][t_to].cnt;
+    if (i >= 0) {
+      for_each_agent(v_to->id, t_to, [&](int j) {
+        if (j == i) --collision;
+      });
+    }
   }
   // edge collision
-  if (t_to < body[v_from->id].size() && t_from < body[v_to->id].size()) {
-    for (auto j : body[v_from->id][t_to]) {
-      for (auto k : body[v_to->id][t_from]) {
+  if (t_to < (int)body[v_from->id].size() &&
+      t_from < (int)body[v_to->id].size() &&
+      body[v_from->id][t_to].cnt > 0 && body[v_to->id][t_from].cnt > 0) {
+    for_each_agent(v_from->id, t_to, [&](int j) {
+      if (j == i) return;
+      for_each_agent(v_to->id, t_from, [&](int k) {
         if (j == k) ++collision;
-      }
-    }
+      });
+    });
   }
   // goal collision
-  for (auto last_timestep : body_last[v_to->id]) {
-    if (t_to > last_timestep) ++collision;
+  collision += get_goal_arrivals_before(v_to->id, t_to);
+  if (i >= 0 && i < (int)body_last_agent.size() &&
+      body_last_agent[i].first == v_to->id &&
+      t_to > body_last_agent[i].second) {
+    --collision;
   }
   return collision;
 }
@@ -37,23 +56,27 @@ int CollisionTable::getCollisionCost(const Vertex *v_from, const Vertex *v_to,
 void CollisionTable::enrollPath(const int i, Path &path)
 {
   if (path.empty()) return;
-  const auto T_i = path.size() - 1;
+  const auto T_i = (int)path.size() - 1;
   for (auto t = 0; t <= T_i; ++t) {
-    auto v = path[t];
-
     // update collision count
     if (t > 0) collision_cnt += getCollisionCost(path[t - 1], path[t], t - 1);
 
     // register
-    while (body[v->id].size() <= t) body[v->id].emplace_back();
-    body[v->id][t].push_back(i);
+    insert(path[t]->id, t, i);
+    if (t > 0 && path[t - 1] != path[t]) add_move(path[t - 1], path[t], t - 1);
   }
 
   // goal
-  body_last[path.back()->id].push_back(T_i);
-  auto &&entry = body[path.back()->id];
-  for (auto t = T_i + 1; t < entry.size(); ++t) {
-    collision_cnt += entry[t].size();
+  const auto g_id = path.back()->id;
+  auto &&entry_last = body_last[g_id];
+  entry_last.insert(std::upper_bound(entry_last.begin(), entry_last.end(), T_i),
+                    T_i);
+  if (i >= (int)body_last_agent.size())
+    body_last_agent.resize(i + 1, std::make_pair(-1, -1));
+  body_last_agent[i] = std::make_pair(g_id, T_i);
+  auto &&entry = body[g_id];
+  for (auto t = T_i + 1; t < (int)entry.size(); ++t) {
+    collision_cnt += entry[t].cnt;
   }
 }
 
@@ -62,35 +85,288 @@ void CollisionTable::clearPath(const int i, Path &path)
   if (path.empty()) return;
   const auto T_i = (int)path.size() - 1;
   for (auto t = 0; t <= T_i; ++t) {
-    auto v = path[t];
-    auto &&entry = body[v->id][t];
-
     // remove entry
-    for (auto itr = entry.begin(); itr != entry.end();) {
-      if (*itr == i) {
-        entry.erase(itr);
-        break;
-      } else {
-        ++itr;
-      }
-    }
+    remove(path[t]->id, t, i);
+    if (t > 0 && path[t - 1] != path[t])
+      remove_move(path[t - 1], path[t], t - 1);
 
     // update collision count
     if (t > 0) collision_cnt -= getCollisionCost(path[t - 1], path[t], t - 1);
   }
 
   // goal
-  auto &&entry_body_last = body_last[path.back()->id];
-  for (auto itr = entry_body_last.begin(); itr != entry_body_last.end();) {
-    if (*itr == T_i) {
-      entry_body_last.erase(itr);
-      break;
+  const auto g_id = path.back()->id;
+  auto &&entry_last = body_last[g_id];
+  auto itr = std::lower_bound(entry_last.begin(), entry_last.end(), T_i);
+  if (itr != entry_last.end() && *itr == T_i) {
+    entry_last.erase(itr);
+    body_last_agent[i] = std::make_pair(-1, -1);
+  }
+  auto &&entry = body[g_id];
+  for (auto t = T_i + 1; t < (int)entry.size(); ++t) {
+    collision_cnt -= entry[t].cnt;
+  }
+
+  for (auto v : path) compact(v->id);
+}
+
+void CollisionTable::shrink()
+{
+  for (size_t v_id = 0; v_id < body.size(); ++v_id) {
+    compact(v_id);
+    body[v_id].shrink_to_fit();
+    body_last[v_id].shrink_to_fit();
+    safe_intervals[v_id].shrink_to_fit();
+    for (auto &edge : moves[v_id]) {
+      edge.times.shrink_to_fit();
+      edge.cnts.shrink_to_fit();
+    }
+  }
+  overflow.rehash(0);
+}
+
+int CollisionTable::get_horizon(const int v_id) const
+{
+  return body[v_id].size();
+}
+
+int CollisionTable::get_agents_num(const int v_id, const int t) const
+{
+  return (t < (int)body[v_id].size()) ? body[v_id][t].cnt : 0;
+}
+
+int CollisionTable::get_first_goal_arrival(const int v_id) const
+{
+  return body_last[v_id].empty() ? INT_MAX : body_last[v_id].front();
+}
+
+SIRange CollisionTable::get_safe_intervals(const int v_id) const
+{
+  auto &&entry = safe_intervals[v_id];
+  if (entry.empty()) return SIRange{&FULL_INTERVAL, &FULL_INTERVAL + 1};
+  const auto first = entry.data();
+  const auto t_last = get_first_goal_arrival(v_id);
+  if (t_last == INT_MAX) return SIRange{first, first + entry.size()};
+  // the vertex is occupied at t_last, intervals after that are not safe
+  auto itr = std::lower_bound(
+      entry.begin(), entry.end(), t_last,
+      [](const SI &si, const int t) { return si.first < t; });
+  return SIRange{first, first + (itr - entry.begin())};
+}
+
+int CollisionTable::find_safe_interval(const int v_id, const int t) const
+{
+  auto range = get_safe_intervals(v_id);
+  auto itr = std::upper_bound(
+      range.begin(), range.end(), t,
+      [](const int t, const SI &si) { return t < si.first; });
+  if (itr == range.begin()) return -1;
+  --itr;
+  return (t <= itr->second) ? itr - range.begin() : -1;
+}
+
+int CollisionTable::get_earliest_departure(const Vertex *v_from, const int k,
+                                           const int t_lo, const int t_hi) const
+{
+  if (t_lo > t_hi) return -1;
+  auto edge = get_moves(v_from, k);
+  if (edge == nullptr) return t_lo;
+  auto &times = edge->times;
+  const int p = std::lower_bound(times.begin(), times.end(), t_lo) -
+                times.begin();
+  if (p == (int)times.size() || times[p] > t_lo) return t_lo;
+  // times[j] - j is constant within a run of consecutive timesteps
+  const auto key = times[p] - p;
+  auto lo = p;
+  auto hi = (int)times.size();
+  while (lo + 1 < hi) {
+    const auto mid = (lo + hi) / 2;
+    if (times[mid] - mid == key) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  const auto t = times[lo] + 1;
+  return (t <= t_hi) ? t : -1;
+}
+
+int CollisionTable::get_latest_departure(const Vertex *v_from, const int k,
+                                         const int t_lo, const int t_hi) const
+{
+  if (t_lo > t_hi) return -1;
+  auto edge = get_moves(v_from, k);
+  if (edge == nullptr) return t_hi;
+  auto &times = edge->times;
+  const int p =
+      std::upper_bound(times.begin(), times.end(), t_hi) - times.begin() - 1;
+  if (p < 0 || times[p] < t_hi) return t_hi;
+  const auto key = times[p] - p;
+  auto lo = -1;
+  auto hi = p;
+  while (lo + 1 < hi) {
+    const auto mid = (lo + hi) / 2;
+    if (times[mid] - mid == key) {
+      hi = mid;
     } else {
-      ++itr;
+      lo = mid;
     }
   }
-  auto &&entry_body = body[path.back()->id];
-  for (auto t = T_i + 1; t < entry_body.size(); ++t) {
-    collision_cnt -= entry_body[t].size();
+  const auto t = times[hi] - 1;
+  return (t >= t_lo) ? t : -1;
+}
+
+int CollisionTable::get_goal_arrivals_before(const int v_id, const int t) const
+{
+  auto &&entry_last = body_last[v_id];
+  if (entry_last.empty() || entry_last.front() >= t) return 0;
+  return std::lower_bound(entry_last.begin(), entry_last.end(), t) -
+         entry_last.begin();
+}
+
+uint64_t CollisionTable::get_key(const int v_id, const int t)
+{
+  return ((uint64_t)v_id << 32) | (uint32_t)t;
+}
+
+void CollisionTable::insert(const int v_id, const int t, const int i)
+{
+  auto &&entry = body[v_id];
+  if ((int)entry.size() <= t) entry.resize(t + 1);
+  auto &cell = entry[t];
+  if (cell.cnt < CollisionCell::INLINE_SIZE) {
+    cell.agents[cell.cnt] = i;
+  } else {
+    overflow[get_key(v_id, t)].push_back(i);
+  }
+  if (++cell.cnt == 1) occupy(v_id, t);
+}
+
+void CollisionTable::remove(const int v_id, const int t, const int i)
+{
+  if (t >= (int)body[v_id].size()) return;
+  auto &cell = body[v_id][t];
+  const auto k_max = std::min(cell.cnt, CollisionCell::INLINE_SIZE);
+  auto k = 0;
+  while (k < k_max && cell.agents[k] != i) ++k;
+
+  if (cell.cnt <= CollisionCell::INLINE_SIZE) {
+    if (k == k_max) return;  // not found
+    cell.agents[k] = cell.agents[cell.cnt - 1];
+    if (--cell.cnt == 0) release(v_id, t);
+    return;
+  }
+
+  // refill the inline list from the overflow
+  auto itr = overflow.find(get_key(v_id, t));
+  auto &extra = itr->second;
+  if (k == k_max) {
+    auto itr_i = std::find(extra.begin(), extra.end(), i);
+    if (itr_i == extra.end()) return;  // not found
+    *itr_i = extra.back();
+  } else {
+    cell.agents[k] = extra.back();
+  }
+  extra.pop_back();
+  if (extra.empty()) overflow.erase(itr);
+  --cell.cnt;  // still more than INLINE_SIZE, i.e., occupied
+}
+
+void CollisionTable::compact(const int v_id)
+{
+  auto &&entry = body[v_id];
+  while (!entry.empty() && entry.back().cnt == 0) entry.pop_back();
+  if (entry.empty()) safe_intervals[v_id].clear();  // i.e., FULL_INTERVAL
+}
+
+void CollisionTable::occupy(const int v_id, const int t)
+{
+  auto &&entry = safe_intervals[v_id];
+  if (entry.empty()) entry.push_back(FULL_INTERVAL);
+  // interval containing t
+  auto itr =
+      std::upper_bound(entry.begin(), entry.end(), t,
+                       [](const int t, const SI &si) { return t < si.first; });
+  --itr;
+  const auto [t_s, t_e] = *itr;
+  if (t_s == t && t_e == t) {
+    entry.erase(itr);
+  } else if (t_s == t) {
+    itr->first = t + 1;
+  } else if (t_e == t) {
+    itr->second = t - 1;
+  } else {
+    itr->second = t - 1;
+    entry.insert(itr + 1, SI(t + 1, t_e));
+  }
+}
+
+void CollisionTable::release(const int v_id, const int t)
+{
+  auto &&entry = safe_intervals[v_id];
+  // first interval after t
+  auto itr_next =
+      std::upper_bound(entry.begin(), entry.end(), t,
+                       [](const int t, const SI &si) { return t < si.first; });
+  const auto flg_prev =
+      itr_next != entry.begin() && (itr_next - 1)->second == t - 1;
+  const auto flg_next = itr_next != entry.end() && itr_next->first == t + 1;
+  if (flg_prev && flg_next) {
+    (itr_next - 1)->second = itr_next->second;
+    entry.erase(itr_next);
+  } else if (flg_prev) {
+    (itr_next - 1)->second = t;
+  } else if (flg_next) {
+    itr_next->first = t;
+  } else {
+    entry.insert(itr_next, SI(t, t));
+  }
+}
+
+const EdgeTimes *CollisionTable::get_moves(const Vertex *v, const int k) const
+{
+  auto &&entry = moves[v->id];
+  if (entry.empty() || entry[k].times.empty()) return nullptr;
+  return &entry[k];
+}
+
+EdgeTimes *CollisionTable::find_moves(const Vertex *v_from, const Vertex *v_to)
+{
+  // stored at the destination
+  auto &&entry = moves[v_to->id];
+  if (entry.empty()) entry.resize(v_to->neighbor.size());
+  const auto K = v_to->neighbor.size();
+  for (size_t k = 0; k < K; ++k) {
+    if (v_to->neighbor[k] == v_from) return &entry[k];
+  }
+  return nullptr;  // not adjacent
+}
+
+void CollisionTable::add_move(const Vertex *v_from, const Vertex *v_to,
+                              const int t)
+{
+  auto edge = find_moves(v_from, v_to);
+  if (edge == nullptr) return;
+  auto itr = std::lower_bound(edge->times.begin(), edge->times.end(), t);
+  const auto p = itr - edge->times.begin();
+  if (itr != edge->times.end() && *itr == t) {
+    ++edge->cnts[p];
+  } else {
+    edge->times.insert(itr, t);
+    edge->cnts.insert(edge->cnts.begin() + p, 1);
+  }
+}
+
+void CollisionTable::remove_move(const Vertex *v_from, const Vertex *v_to,
+                                 const int t)
+{
+  auto edge = find_moves(v_from, v_to);
+  if (edge == nullptr) return;
+  auto itr = std::lower_bound(edge->times.begin(), edge->times.end(), t);
+  if (itr == edge->times.end() || *itr != t) return;
+  const auto p = itr - edge->times.begin();
+  if (--edge->cnts[p] == 0) {
+    edge->times.erase(itr);
+    edge->cnts.erase(edge->cnts.begin() + p);
   }
 }
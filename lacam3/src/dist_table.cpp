@@ -1,42 +1,110 @@
 #include "../include/dist_table.hpp"
 
-DistTable::DistTable(const Instance &ins)
-    : K(ins.G->V.size()), table(ins.N, std::vector<int>(K, K))
+DistCache::DistCache(const Graph *_G, const size_t _capacity)
+    : G(_G),
+      capacity(_capacity),
+      mtx(),
+      rows(),
+      history(),
+      num_hits(0),
+      num_misses(0)
 {
-  setup(&ins);
 }
 
-DistTable::DistTable(const Instance *ins)
-    : K(ins->G->V.size()), table(ins->N, std::vector<int>(K, K))
+DistRow DistCache::find(const Vertex *goal)
 {
-  setup(ins);
+  std::lock_guard<std::mutex> lock(mtx);
+  auto iter = rows.find(goal->id);
+  if (iter == rows.end()) {
+    ++num_misses;
+    return nullptr;
+  }
+  ++num_hits;
+  return iter->second;
+}
+
+void DistCache::insert(const Vertex *goal, DistRow row)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  if (!rows.emplace(goal->id, row).second) return;  // by another table
+  history.push_back(goal->id);
+  // tables in use keep their own references
+  while (rows.size() > capacity) {
+    rows.erase(history.front());
+    history.pop_front();
+  }
 }
 
-void DistTable::setup(const Instance *ins)
+DistRow get_dist_row(const Graph *G, const Vertex *goal, const int radius)
 {
-  auto bfs = [&](const int i) {
-    auto g_i = ins->goals[i];
-    auto Q = std::queue<Vertex *>({g_i});
-    table[i][g_i->id] = 0;
-    while (!Q.empty()) {
-      auto n = Q.front();
-      Q.pop();
-      const int d_n = table[i][n->id];
-      for (auto &m : n->neighbor) {
-        const int d_m = table[i][m->id];
-        if (d_n + 1 >= d_m) continue;
-        table[i][m->id] = d_n + 1;
-        Q.push(m);
-      }
+  const int K = G->V.size();
+  auto row = std::make_shared<std::vector<int>>(K, K);
+  auto &dist = *row;
+  auto Q = std::queue<const Vertex *>({goal});
+  dist[goal->id] = 0;
+  while (!Q.empty()) {
+    auto n = Q.front();
+    Q.pop();
+    const int d_n = dist[n->id];
+    if (d_n >= radius) continue;
+    for (auto &m : n->neighbor) {
+      const int d_m = dist[m->id];
+      if (d_n + 1 >= d_m) continue;
+      dist[m->id] = d_n + 1;
+      Q.push(m);
     }
-  };
+  }
+  return row;
+}
+
+DistTable::DistTable(const Instance &ins) : DistTable(&ins) {}
+
+DistTable::DistTable(const Instance *ins, DistCache *cache)
+    : K(ins->G->V.size()), rows(ins->N), table(ins->N)
+{
+  setup(ins, cache);
+}
+
+DistTable::DistTable(const Instance *ins, const int radius,
+                     const TaskPriority priority)
+    : K(ins->G->V.size()), rows(ins->N), table(ins->N)
+{
+  setup(ins, nullptr, radius, priority);
+}
+
+void DistTable::setup(const Instance *ins, DistCache *cache, const int radius,
+                      const TaskPriority priority)
+{
+  if (radius != INT_MAX) cache = nullptr;
+  // agents sharing a goal use the same row
+  auto first_agent = std::unordered_map<int, size_t>();
+  auto executor = get_executor();
+  auto group = TaskGroup();
+  for (size_t i = 0; i < ins->N; ++i) {
+    if (!first_agent.emplace(ins->goals[i]->id, i).second) continue;
+    if (cache != nullptr) rows[i] = cache->find(ins->goals[i]);
+    if (rows[i] != nullptr) continue;
+    executor->submit(
+        group,
+        [&, i] { rows[i] = get_dist_row(ins->G, ins->goals[i], radius); },
+        priority);
+  }
+  executor->wait(group);
 
-  auto pool = std::vector<std::future<void>>();
   for (size_t i = 0; i < ins->N; ++i) {
-    pool.emplace_back(std::async(std::launch::async, bfs, i));
+    const auto j = first_agent[ins->goals[i]->id];
+    if (j == i && cache != nullptr) cache->insert(ins->goals[i], rows[i]);
+    rows[i] = rows[j];
+    table[i] = rows[i]->data();
   }
 }
 
+void DistTable::set_row(const int i, DistRow row)
+{
+  rows[i] = row;
+  table[i] = rows[i]->data();
+}
+
 int DistTable::get(const int i, const int v_id) { return table[i][v_id]; }
 
 int DistTable::get(const int i, const Vertex *v) { return get(i, v->id); }
@@ -0,0 +1,103 @@
+#include "../include/executor.hpp"
+
+TaskGroup::TaskGroup() : num_pending(0) {}
+
+int Executor::NUM_THREADS = 0;
+
+Executor::Executor(const int num_threads)
+    : threads(), queues(), mtx(), cv_task(), cv_done(), flg_stop(false)
+{
+  for (auto k = 0; k < num_threads; ++k) {
+    threads.emplace_back(&Executor::work, this);
+  }
+}
+
+Executor::~Executor()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    flg_stop = true;
+  }
+  cv_task.notify_all();
+  for (auto &th : threads) th.join();
+}
+
+void Executor::submit(TaskGroup &group, std::function<void()> fn,
+                      const TaskPriority priority)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++group.num_pending;
+    queues[priority].push_back({std::move(fn), &group});
+  }
+  cv_task.notify_one();
+}
+
+void Executor::wait(TaskGroup &group)
+{
+  auto task = Task();
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (group.num_pending == 0) return;
+      if (!pop(task, &group)) {
+        // the rest are running on other threads
+        cv_done.wait(lock, [&] { return group.num_pending == 0; });
+        return;
+      }
+    }
+    run(task);
+  }
+}
+
+bool Executor::pop(Task &task, const TaskGroup *group)
+{
+  for (auto &queue : queues) {
+    auto itr = queue.begin();
+    if (group != nullptr) {
+      itr = std::find_if(queue.begin(), queue.end(),
+                         [&](auto &t) { return t.group == group; });
+    }
+    if (itr == queue.end()) continue;
+    task = std::move(*itr);
+    queue.erase(itr);
+    return true;
+  }
+  return false;
+}
+
+void Executor::run(Task &task)
+{
+  task.fn();
+  task.fn = nullptr;  // release captures before the group is done
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    --task.group->num_pending;
+  }
+  cv_done.notify_all();
+}
+
+void Executor::work()
+{
+  auto task = Task();
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_task.wait(lock, [&] {
+        return flg_stop || !queues[0].empty() || !queues[1].empty();
+      });
+      if (!pop(task, nullptr)) return;  // stopped
+    }
+    run(task);
+  }
+}
+
+Executor *get_executor()
+{
+  static Executor executor(
+      std::max(1, (Executor::NUM_THREADS > 0
+                       ? Executor::NUM_THREADS
+                       : (int)std::thread::hardware_concurrency()) -
+                      1));
+  return &executor;
+}
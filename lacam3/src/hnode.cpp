@@ -2,8 +2,6 @@
 
 #include <random>
 
-int HNode::COUNT = 0;
-
 HNode::HNode(Config _C, DistTable *D, HNode *_parent, int _g, int _h)
     : C(_C),
       parent(_parent),
@@ -11,14 +9,13 @@ HNode::HNode(Config _C, DistTable *D, HNode *_parent, int _g, int _h)
       g(_g),
       h(_h),
       f(g + h),
+      depth(parent == nullptr ? 0 : parent->depth + 1),
       priorities(C.size(), 0),
       order(C.size(), 0),
-      search_tree(std::queue<LNode *>())
+      search_tree(std::queue<LNode *>()),
+      search_tree_mtx()
 {
-  ++COUNT;
-
   search_tree.push(new LNode());
-  const auto N = C.size();
 
   // update neighbor
   if (parent != nullptr) {
@@ -26,6 +23,17 @@ HNode::HNode(Config _C, DistTable *D, HNode *_parent, int _g, int _h)
     parent->neighbor.insert(this);
   }
 
+  set_priorities(C, D, parent, priorities, order);
+}
+
+void HNode::set_priorities(const Config &C, DistTable *D, const HNode *parent,
+                           std::vector<float> &priorities,
+                           std::vector<int> &order)
+{
+  const auto N = C.size();
+  priorities.resize(N);
+  order.resize(N);
+
   // set priorities
   if (parent == nullptr) {
     // initialize
@@ -55,8 +63,10 @@ HNode::~HNode()
   }
 }
 
-LNode *HNode::get_next_lowlevel_node(std::mt19937 &MT)
+LNode *HNode::get_next_lowlevel_node(std::mt19937 &MT,
+                                     std::atomic<int> &num_lnodes)
 {
+  std::lock_guard<std::mutex> lock(search_tree_mtx);
   if (search_tree.empty()) return nullptr;
 
   auto L = search_tree.front();
@@ -67,6 +77,7 @@ LNode *HNode::get_next_lowlevel_node(std::mt19937 &MT)
     cands.push_back(C[i]);
     std::shuffle(cands.begin(), cands.end(), MT);  // randomize
     for (auto u : cands) search_tree.push(new LNode(L, i, u));
+    num_lnodes += cands.size();
   }
   return L;
 }
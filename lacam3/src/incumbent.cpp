@@ -0,0 +1,85 @@
+#include "../include/incumbent.hpp"
+
+Incumbent::Incumbent(const Solution &solution)
+    : paths(),
+      loss(get_sum_of_loss(solution)),
+      makespan(get_makespan(solution))
+{
+  for (auto &path : translateConfigsToPaths(solution)) {
+    paths.push_back(std::make_shared<const Path>(std::move(path)));
+  }
+}
+
+Incumbent::Incumbent(const Incumbent &base, const PlanDiff &diff)
+    : paths(base.paths), loss(base.loss + diff.loss_delta), makespan(0)
+{
+  const auto M = diff.agents.size();
+  for (size_t k = 0; k < M; ++k) {
+    paths[diff.agents[k]] = std::make_shared<const Path>(diff.paths[k]);
+  }
+  for (auto &path : paths) makespan = std::max(makespan, (int)path->size() - 1);
+}
+
+Config Incumbent::get_config(const int t) const
+{
+  const auto N = paths.size();
+  auto C = Config(N, nullptr);
+  for (size_t i = 0; i < N; ++i) {
+    auto &path = *paths[i];
+    C[i] = path[std::min(t, (int)path.size() - 1)];
+  }
+  return C;
+}
+
+Solution Incumbent::get_solution() const
+{
+  Solution solution;
+  for (auto t = 0; t <= makespan; ++t) solution.push_back(get_config(t));
+  return solution;
+}
+
+PlanDiff::PlanDiff(IncumbentPtr _base)
+    : base(_base),
+      agents(),
+      paths(),
+      t_min(INT_MAX),
+      t_max(-1),
+      loss_delta(0)
+{
+}
+
+PlanDiff::PlanDiff(IncumbentPtr _base, const Solution &solution)
+    : PlanDiff(_base)
+{
+  if (solution.empty()) return;
+  auto new_paths = translateConfigsToPaths(solution);
+  const auto N = new_paths.size();
+  for (size_t i = 0; i < N; ++i) {
+    if (new_paths[i] != *base->paths[i]) add(i, new_paths[i]);
+  }
+}
+
+void PlanDiff::add(const int i, const Path &path)
+{
+  auto &old_path = *base->paths[i];
+  const auto T_old = (int)old_path.size() - 1;
+  const auto T_new = (int)path.size() - 1;
+  auto differs = [&](const int t) {
+    return old_path[std::min(t, T_old)] != path[std::min(t, T_new)];
+  };
+  // locations after max(T_old, T_new) never change
+  const auto T = std::max(T_old, T_new);
+  auto t_first = 0;
+  while (t_first <= T && !differs(t_first)) ++t_first;
+  if (t_first > T) return;  // identical
+  auto t_last = T;
+  while (!differs(t_last)) --t_last;
+
+  agents.push_back(i);
+  paths.push_back(path);
+  t_min = std::min(t_min, t_first);
+  t_max = std::max(t_max, t_last);
+  loss_delta += get_path_loss(path) - get_path_loss(old_path);
+}
+
+bool PlanDiff::empty() const { return agents.empty(); }
@@ -1,9 +1,76 @@
 #include "../include/lacam.hpp"
 
 Solution solve(const Instance &ins, int verbose, const Deadline *deadline,
-               int seed)
+               int seed, const PlannerOptions &options, PlannerStats *stats,
+               DistTable *D)
 {
+  if (options.portfolio_num > 1 && options.flg_multi_thread) {
+    return solve_portfolio(ins, options.portfolio_num, verbose, deadline, seed,
+                           options, stats, D);
+  }
   info(1, verbose, deadline, "pre-processing");
-  auto planner = Planner(&ins, verbose, deadline, seed);
-  return planner.solve();
+  auto planner = Planner(&ins, verbose, deadline, seed, 0, D, options);
+  auto solution = planner.solve();
+  if (stats != nullptr) *stats = planner.stats;
+  return solution;
+}
+
+Solution solve_portfolio(const Instance &ins, const int _K, const int verbose,
+                         const Deadline *deadline, int seed,
+                         const PlannerOptions &options, PlannerStats *stats,
+                         DistTable *D)
+{
+  info(1, verbose, deadline, "pre-processing");
+  // members occupy workers until the deadline, one is left for refiners
+  auto executor = get_executor();
+  const int num_workers = executor->threads.size();
+  const auto flg_refining = options.flg_star && options.flg_refiner;
+  const auto K = std::min(_K, std::max(1, num_workers + 1 - flg_refining));
+  if (K < _K) {
+    info(1, verbose, deadline, "portfolio is limited by threads: ", K);
+  }
+  auto D_shared = D == nullptr ? new DistTable(ins) : D;
+  auto portfolio = Portfolio(deadline);
+  auto deadline_members = Deadline(deadline, &portfolio.cancel);
+
+  // the first member uses the given parameters, the others are randomized
+  auto MT = std::mt19937(seed);
+  auto planners = std::vector<Planner *>();
+  for (auto k = 0; k < K; ++k) {
+    auto options_k = options;
+    if (k > 0) {
+      options_k.pibt_num = get_random_int(MT, 1, 2 * options.pibt_num);
+      options_k.scatter_margin = get_random_int(MT, 0, 30);
+      options_k.recursive_rate = get_random_float(MT, 0, 0.5);
+    }
+    auto planner = new Planner(&ins, k == 0 ? verbose : 0, &deadline_members,
+                               seed + k, 0, D_shared, options_k);
+    planner->portfolio = &portfolio;
+    planner->portfolio_id = k;
+    info(2, verbose, deadline, "portfolio-", k,
+         "\tpibt_num: ", options_k.pibt_num,
+         ", scatter_margin: ", options_k.scatter_margin,
+         ", recursive_rate: ", options_k.recursive_rate);
+    planners.push_back(planner);
+  }
+
+  auto solutions = std::vector<Solution>(K);
+  auto group = TaskGroup();
+  for (auto k = 1; k < K; ++k) {
+    executor->submit(
+        group, [&, k] { solutions[k] = planners[k]->solve(); },
+        PRIORITY_HIGH);
+  }
+  solutions[0] = planners[0]->solve();
+  executor->wait(group);
+  if (stats != nullptr) *stats = planners[0]->stats;
+  for (auto planner : planners) delete planner;
+  if (D == nullptr) delete D_shared;
+
+  // every member publishes its last solution before finishing
+  auto best = portfolio.get();
+  if (best == nullptr) return solutions[0];
+  info(1, verbose, deadline, "portfolio-", portfolio.source,
+       "\tfound the best solution, cost: ", best->loss);
+  return best->get_solution();
 }
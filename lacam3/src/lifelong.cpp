@@ -0,0 +1,90 @@
+#include "../include/lifelong.hpp"
+
+static PlannerOptions get_lifelong_options(const PlannerOptions &options)
+{
+  // SUO guides agents to goals of its construction
+  auto res = options;
+  res.flg_scatter = false;
+  return res;
+}
+
+Lifelong::Lifelong(const Instance *_ins, const PlannerOptions &_options,
+                   const int _verbose, const size_t dist_cache_capacity)
+    : ins(_ins),
+      options(get_lifelong_options(_options)),
+      verbose(_verbose),
+      dist_cache(ins->G, dist_cache_capacity),
+      D(new DistTable(ins, &dist_cache)),
+      goals(ins->goals),
+      goals_requested(ins->goals),
+      bfs_group(),
+      bfs_results(),
+      plan(),
+      num_ticks(0),
+      num_goal_updates(0),
+      num_rows_computed(0)
+{
+}
+
+Lifelong::~Lifelong()
+{
+  get_executor()->wait(bfs_group);
+  delete D;
+}
+
+void Lifelong::set_goal(const int i, Vertex *goal)
+{
+  if (goal == goals_requested[i]) return;
+  ++num_goal_updates;
+  goals_requested[i] = goal;
+  auto row = dist_cache.find(goal);
+  if (row != nullptr) {
+    goals[i] = goal;
+    D->set_row(i, row);
+    return;
+  }
+  // search is favored, the goal is applied in later ticks
+  get_executor()->submit(
+      bfs_group,
+      [this, i, goal] {
+        bfs_results.push(GoalUpdate{i, goal, get_dist_row(ins->G, goal)});
+      },
+      PRIORITY_LOW);
+}
+
+void Lifelong::apply_goal_updates()
+{
+  for (auto &update : bfs_results.pop_all()) {
+    ++num_rows_computed;
+    dist_cache.insert(update.goal, update.row);
+    // outdated by another request
+    if (update.goal != goals_requested[update.agent]) continue;
+    goals[update.agent] = update.goal;
+    D->set_row(update.agent, update.row);
+  }
+}
+
+void Lifelong::sync()
+{
+  get_executor()->wait(bfs_group);
+  apply_goal_updates();
+}
+
+int Lifelong::get_num_pending() const
+{
+  auto cnt = 0;
+  for (size_t i = 0; i < ins->N; ++i) cnt += goals[i] != goals_requested[i];
+  return cnt;
+}
+
+Solution Lifelong::tick(const Config &C, const Deadline *deadline, int seed)
+{
+  ++num_ticks;
+  apply_goal_updates();
+  plan_horizon(ins->G, C, goals, D, nullptr, options, deadline, seed,
+               verbose - 1, plan);
+  info(2, verbose, deadline, "tick-", num_ticks, "\tsteps: ",
+       std::max(0, (int)plan.size() - 1), ", pending goals: ",
+       get_num_pending());
+  return plan;
+}
@@ -13,7 +13,8 @@ PIBT::PIBT(const Instance *_ins, DistTable *_D, int seed, bool _flg_swap,
       C_next(N, std::array<Vertex *, 5>()),
       tie_breakers(V_size, 0),
       flg_swap(_flg_swap),
-      scatter(_scatter)
+      scatter(_scatter),
+      scatter_data(nullptr)
 {
 }
 
@@ -23,6 +24,9 @@ bool PIBT::set_new_config(const Config &Q_from, Config &Q_to,
                           const std::vector<int> &order)
 {
   bool success = true;
+  // scatter may be updated in background
+  if (scatter != nullptr) scatter_data = scatter->get_scatter_data();
+
   // setup cache & constraints check
   for (auto i = 0; i < N; ++i) {
     // set occupied now
@@ -69,11 +73,8 @@ bool PIBT::funcPIBT(const int i, const Config &Q_from, Config &Q_to)
 
   // exploit scatter data
   Vertex *prioritized_vertex = nullptr;
-  if (scatter != nullptr) {
-    auto itr_s = scatter->scatter_data[i].find(Q_from[i]->id);
-    if (itr_s != scatter->scatter_data[i].end()) {
-      prioritized_vertex = itr_s->second;
-    }
+  if (scatter_data != nullptr) {
+    prioritized_vertex = scatter_data->get(i, Q_from[i]->id);
   }
 
   // set C_next
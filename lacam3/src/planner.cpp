@@ -3,28 +3,28 @@
 #include <algorithm>
 #include <iostream>
 
-bool Planner::FLG_SWAP = true;
-bool Planner::FLG_STAR = true;
-bool Planner::FLG_MULTI_THREAD = true;
-int Planner::SCATTER_MARGIN = 10;
-int Planner::PIBT_NUM = 10;
-bool Planner::FLG_REFINER = true;
-int Planner::REFINER_NUM = 4;
-bool Planner::FLG_SCATTER = true;
-float Planner::RANDOM_INSERT_PROB1 = 0.1;
-float Planner::RANDOM_INSERT_PROB2 = 0.01;
-bool Planner::FLG_RANDOM_INSERT_INIT_NODE = false;
-float Planner::RECURSIVE_RATE = 0.2;
-double Planner::RECURSIVE_TIME_LIMIT = 1000;
-
-std::string Planner::MSG;
-int Planner::CHECKPOINTS_DURATION = 5000;
 constexpr int CHECKPOINTS_NIL = -1;
-
-constexpr auto TIME_ZERO = std::chrono::seconds(0);
+constexpr int SPECULATION_DEPTH = 16;  // nodes in OPEN checked in prediction
+
+Speculation::Speculation()
+    : C(),
+      priorities(),
+      order(),
+      who(),
+      where(),
+      Q_cands(),
+      f_vals(),
+      group(),
+      flg_cancelled(false),
+      flg_active(false),
+      num_hits(0),
+      num_misses(0)
+{
+}
 
 Planner::Planner(const Instance *_ins, int _verbose, const Deadline *_deadline,
-                 int _seed, int _depth, DistTable *_D)
+                 int _seed, int _depth, DistTable *_D,
+                 const PlannerOptions &_options)
     : ins(_ins),
       deadline(_deadline),
       seed(_seed),
@@ -37,24 +37,52 @@ Planner::Planner(const Instance *_ins, int _verbose, const Deadline *_deadline,
       delete_dist_table_after_used(_D == nullptr),
       heuristic(new Heuristic(ins, D)),
       scatter(nullptr),
+      delete_scatter_after_used(true),
+      scatter_deadline(nullptr),
+      scatter_group(),
+      pibt_num(_options.flg_fast_first ? 1 : _options.pibt_num),
+      pibts(),
+      pibts_spec(),
+      spec(),
       seed_refiner(0),
-      refiner_pool(),
+      refiner_group(),
+      refiner_results(),
+      refiner_running(0),
+      refiner_cancel(deadline == nullptr ? nullptr : deadline->cancel_token),
+      refiner_deadline(nullptr),
+      incumbent(nullptr),
+      refiner_mtx(),
+      refiner_sessions(),
       OPEN(),
       EXPLORED(),
       H_init(nullptr),
       H_goal(nullptr),
-      search_iter(0),
-      time_initial_solution(-1),
-      cost_initial_solution(-1),
-      checkpoints()
+      warm_start(),
+      graph_mtx(),
+      f_bound(INT_MAX),
+      flg_search_stop(false),
+      options(_options),
+      stats(),
+      portfolio(nullptr),
+      portfolio_id(0),
+      portfolio_seen(nullptr),
+      reported(nullptr),
+      priority(depth == 0 ? PRIORITY_HIGH : PRIORITY_LOW)
 {
 }
 
 Planner::~Planner()
 {
+  clear_speculation();
+  clear_scatter();
+  clear_refiner();
+  if (refiner_deadline != nullptr) delete refiner_deadline;
   if (heuristic != nullptr) delete heuristic;
-  if (scatter != nullptr) delete scatter;
+  if (scatter != nullptr && delete_scatter_after_used) delete scatter;
+  if (scatter_deadline != nullptr) delete scatter_deadline;
   for (auto &pibt : pibts) delete pibt;
+  for (auto &pibt : pibts_spec) delete pibt;
+  for (auto &session : refiner_sessions) delete session;
   if (delete_dist_table_after_used) delete D;
 }
 
@@ -67,31 +95,36 @@ Solution Planner::solve()
   H_init = create_highlevel_node(ins->starts, nullptr);
   OPEN.push_front(H_init);
 
+  apply_new_solution(warm_start);
+
   set_scatter();
   set_pibt();
+  if (!options.flg_fast_first) launch_scatter();
+
+  if (options.searcher_num > 1 && options.flg_multi_thread) search_parallel();
 
   // search loop
-  while (!OPEN.empty() && !is_expired(deadline)) {
-    search_iter += 1;
+  while (!OPEN.empty() && !is_expired(deadline) && !flg_search_stop) {
+    stats.search_iter += 1;
     update_checkpoints();
 
-    // check pooled procedures
-    refiner_pool.remove_if([&](auto &proc) {
-      if ((proc).wait_for(TIME_ZERO) != std::future_status::ready) return false;
-      apply_new_solution(proc.get());
-      ++seed_refiner;
-      refiner_pool.emplace_back(std::async(std::launch::async,
-                                           &Planner::get_refined_plan, this,
-                                           backtrack(H_goal)));
-      return true;
-    });
+    // check results of refiners
+    if (!refiner_results.empty()) {
+      for (auto &diff : refiner_results.pop_all()) {
+        --refiner_running;
+        apply_new_solution(diff);
+        launch_refiner(get_incumbent());
+      }
+    }
+    sync_portfolio();
+    report_improvement();
 
     // do not pop here!
     auto H = OPEN.front();
 
     // random insert after initial solution found
-    if (H_goal != nullptr && get_random_float(MT) < RANDOM_INSERT_PROB2) {
-      H = FLG_RANDOM_INSERT_INIT_NODE
+    if (H_goal != nullptr && get_random_float(MT) < options.random_insert_prob2) {
+      H = options.flg_random_insert_init_node
               ? H_init
               : OPEN[get_random_int(MT, 0, OPEN.size() - 1)];
     }
@@ -102,19 +135,31 @@ Solution Planner::solve()
       continue;
     }
 
+    // windowed, ends of the horizon with smaller f-values replace the goal
+    if (H_goal != nullptr && options.horizon > 0 && is_goal(H)) {
+      info(2, verbose, deadline, "horizon update, f: ", H_goal->f, " -> ",
+           H->f);
+      H_goal = H;
+      f_bound = H_goal->f.load();
+      continue;
+    }
+
     // check goal condition
-    if (H_goal == nullptr && is_same_config(H->C, ins->goals)) {
-      time_initial_solution = elapsed_ms(deadline);
-      cost_initial_solution = H->g;
+    if (H_goal == nullptr && is_goal(H)) {
+      stats.time_initial_solution = elapsed_ms(deadline);
+      stats.cost_initial_solution = H->g;
       H_goal = H;
+      f_bound = H_goal->f.load();
       info(1, verbose, deadline, "found initial solution, cost: ", H_goal->g);
-      if (!FLG_STAR) break;  // finish search
-      set_refiner();         // refining start
+      report_improvement();
+      if (!options.flg_star) break;  // finish search
+      enable_extras();
+      set_refiner();  // refining start
       continue;
     }
 
     // low level search
-    auto L = H->get_next_lowlevel_node(MT);
+    auto L = H->get_next_lowlevel_node(MT, stats.num_low_level_nodes);
     if (L == nullptr) {
       OPEN.pop_front();
       continue;
@@ -127,18 +172,21 @@ Solution Planner::solve()
     if (!res) continue;
 
     // check explored list
+    // with pipelining, the next node is expanded during the bookkeeping
     auto iter = EXPLORED.find(Q_to);
     if (iter != EXPLORED.end()) {
       // known configuration
-      rewrite(H, iter->second);
+      if (!pibts_spec.empty()) speculate(iter->second);
+      rewrite(H, iter->second, OPEN);
 
-      if (get_random_float(MT) >= RANDOM_INSERT_PROB1) {
+      if (get_random_float(MT) >= options.random_insert_prob1) {
         OPEN.push_front(iter->second);  // usual
       } else {
         OPEN.push_front(H_init);  // sometimes
       }
     } else {
       // new one -> insert
+      if (!pibts_spec.empty()) speculate(H, Q_to);
       auto H_new = create_highlevel_node(Q_to, H);
       OPEN.push_front(H_new);
     }
@@ -146,8 +194,25 @@ Solution Planner::solve()
 
   // clear pooled operaitons
   bool is_optimal = OPEN.empty();
-  for (auto &proc : refiner_pool) apply_new_solution(proc.get());
+  clear_speculation();
+  clear_refiner();
+  sync_portfolio();
+  report_improvement();
+  const auto flg_completed = is_optimal || (H_goal != nullptr && !options.flg_star);
+  if (portfolio != nullptr && flg_completed) {
+    portfolio->cancel.cancel();  // other members stop as well
+  }
   if (is_optimal) OPEN.clear();
+  clear_scatter();
+
+  // windowed, a shorter plan when the budget is exhausted
+  if (H_goal == nullptr && options.horizon > 0) {
+    H_goal = get_deepest_node();
+    if (H_goal != nullptr) {
+      info(1, verbose, deadline, "no end of the horizon, depth: ",
+           H_goal->depth);
+    }
+  }
 
   // end processing
   update_checkpoints();
@@ -157,6 +222,160 @@ Solution Planner::solve()
   return solution;
 }
 
+void Planner::search_parallel()
+{
+  // searcher-0 uses OPEN & pibts of the planner, also handling refiners;
+  // the others occupy workers until the deadline, one is left for refiners
+  auto executor = get_executor();
+  const int num_workers = executor->threads.size();
+  const auto flg_refining = options.flg_star && options.flg_refiner;
+  const auto K = std::min(options.searcher_num,
+                          std::max(1, num_workers + 1 - flg_refining));
+  if (K < options.searcher_num) {
+    info(1, verbose, deadline, "searchers are limited by threads: ", K);
+  }
+  auto opens = std::vector<std::deque<HNode *>>(K - 1, {H_init});
+  auto generators = std::vector<std::vector<PIBT *>>(K - 1);
+  for (auto k = 1; k < K; ++k) {
+    for (auto j = 0; j < options.pibt_num; ++j) {
+      generators[k - 1].push_back(new PIBT(ins, D, seed + k * options.pibt_num + j,
+                                           options.flg_swap, scatter));
+    }
+  }
+  auto iters = std::vector<int>(K, 0);
+  auto group = TaskGroup();
+  for (auto k = 1; k < K; ++k) {
+    executor->submit(
+        group,
+        [&, k] { iters[k] = search(k, opens[k - 1], generators[k - 1]); },
+        priority);
+  }
+  iters[0] = search(0, OPEN, pibts);
+  executor->wait(group);
+
+  // optimality is proven when all searchers run out of nodes
+  for (auto &open : opens) OPEN.insert(OPEN.end(), open.begin(), open.end());
+  for (auto &pibts_k : generators) {
+    for (auto pibt : pibts_k) delete pibt;
+  }
+  for (auto k = 0; k < K; ++k) {
+    info(2, verbose, deadline, "searcher-", k, "\titerations: ", iters[k]);
+    stats.search_iter += iters[k];
+  }
+  flg_search_stop = true;  // skip the serial search loop
+}
+
+int Planner::search(const int id, std::deque<HNode *> &open,
+                    std::vector<PIBT *> &generators)
+{
+  auto MT_s = std::mt19937(seed + id);
+  auto num_iter = 0;
+  auto flg_refining = false;
+  while (!open.empty() && !is_expired(deadline) && !flg_search_stop) {
+    num_iter += 1;
+
+    if (id == 0) {
+      update_checkpoints();
+      if (!flg_refining && f_bound < INT_MAX) {
+        std::lock_guard<std::mutex> lock(graph_mtx);
+        flg_refining = true;
+        enable_extras();
+        set_refiner();  // refining start
+      }
+      if (!refiner_results.empty()) {
+        std::lock_guard<std::mutex> lock(graph_mtx);
+        for (auto &diff : refiner_results.pop_all()) {
+          --refiner_running;
+          apply_new_solution(diff);
+          launch_refiner(get_incumbent());
+        }
+      }
+      if (portfolio != nullptr) {
+        std::lock_guard<std::mutex> lock(graph_mtx);
+        sync_portfolio();
+      }
+      if (options.on_improvement && f_bound < INT_MAX) {
+        std::lock_guard<std::mutex> lock(graph_mtx);
+        report_improvement();
+      }
+    }
+
+    // do not pop here!
+    auto H = open.front();
+    const int f_goal = f_bound;
+
+    // random insert after initial solution found
+    if (f_goal < INT_MAX && get_random_float(MT_s) < options.random_insert_prob2) {
+      H = options.flg_random_insert_init_node
+              ? H_init
+              : open[get_random_int(MT_s, 0, open.size() - 1)];
+    }
+
+    // check lower bounds
+    if (H->f >= f_goal) {
+      open.pop_front();
+      continue;
+    }
+
+    // windowed, ends of the horizon with smaller f-values replace the goal
+    if (f_goal < INT_MAX && options.horizon > 0 && is_goal(H)) {
+      std::lock_guard<std::mutex> lock(graph_mtx);
+      if (H_goal != nullptr && H->f < H_goal->f) {
+        info(2, verbose, deadline, "searcher-", id, " horizon update, f: ",
+             H_goal->f, " -> ", H->f);
+        H_goal = H;
+        f_bound = H_goal->f.load();
+      }
+      continue;  // pruned by the lower bound
+    }
+
+    // check goal condition
+    if (f_goal == INT_MAX && is_goal(H)) {
+      std::lock_guard<std::mutex> lock(graph_mtx);
+      if (H_goal != nullptr) continue;  // found by another searcher
+      stats.time_initial_solution = elapsed_ms(deadline);
+      stats.cost_initial_solution = H->g;
+      H_goal = H;
+      f_bound = H_goal->f.load();
+      info(1, verbose, deadline, "searcher-", id,
+           " found initial solution, cost: ", H_goal->g);
+      if (!options.flg_star) flg_search_stop = true;  // finish search
+      continue;
+    }
+
+    // low level search
+    auto L = H->get_next_lowlevel_node(MT_s, stats.num_low_level_nodes);
+    if (L == nullptr) {
+      open.pop_front();
+      continue;
+    }
+
+    // create successors at the high-level search, without locks
+    auto Q_to = Config(N, nullptr);
+    auto res = set_new_config(H, L, Q_to, generators);
+    delete L;
+    if (!res) continue;
+
+    // check explored list
+    std::lock_guard<std::mutex> lock(graph_mtx);
+    auto iter = EXPLORED.find(Q_to);
+    if (iter != EXPLORED.end()) {
+      // known configuration
+      rewrite(H, iter->second, open);
+      if (get_random_float(MT_s) >= options.random_insert_prob1) {
+        open.push_front(iter->second);  // usual
+      } else {
+        open.push_front(H_init);  // sometimes
+      }
+    } else {
+      // new one -> insert
+      auto H_new = create_highlevel_node(Q_to, H);
+      open.push_front(H_new);
+    }
+  }
+  return num_iter;
+}
+
 HNode *Planner::create_highlevel_node(const Config &Q, HNode *parent)
 {
   auto g_val =
@@ -164,9 +383,41 @@ HNode *Planner::create_highlevel_node(const Config &Q, HNode *parent)
   auto h_val = heuristic->get(Q);
   auto H_new = new HNode(Q, D, parent, g_val, h_val);
   EXPLORED[Q] = H_new;
+  ++stats.num_high_level_nodes;
+  ++stats.num_low_level_nodes;  // root of the low-level search
   return H_new;
 }
 
+bool Planner::is_goal(const HNode *H)
+{
+  if (is_same_config(H->C, ins->goals)) return true;
+  if (options.horizon <= 0 || H->depth == 0) return false;
+  if (H->depth >= options.horizon) return true;
+  if (!options.flg_horizon_progress) return false;
+  for (auto i = 0; i < N; ++i) {
+    if (H->C[i] != ins->goals[i] &&
+        D->get(i, H->C[i]) >= D->get(i, ins->starts[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HNode *Planner::get_deepest_node()
+{
+  // smaller f-value among the deepest, nullptr when no step is found
+  HNode *H_best = nullptr;
+  for (auto &p : EXPLORED) {
+    auto H = p.second;
+    if (H->depth == 0) continue;
+    if (H_best == nullptr || H->depth > H_best->depth ||
+        (H->depth == H_best->depth && H->f < H_best->f)) {
+      H_best = H;
+    }
+  }
+  return H_best;
+}
+
 void Planner::apply_new_solution(const Solution &plan)
 {
   if (plan.empty()) return;
@@ -174,23 +425,56 @@ void Planner::apply_new_solution(const Solution &plan)
 
   // forcibly insert configuration
   HNode *H_from = EXPLORED[plan[0]];
-  HNode *H_to = nullptr;
   for (auto t = 1; t < plan.size(); ++t) {
-    auto &&Q = plan[t];
-    auto iter = EXPLORED.find(Q);
-    if (iter != EXPLORED.end()) {
-      // known
-      H_to = iter->second;
-      rewrite(H_from, H_to);
-    } else {
-      // new
-      auto g_val = H_from->g + get_edge_cost(H_from->C, Q);
-      H_to = new HNode(Q, D, H_from, g_val, heuristic->get(Q));
-      EXPLORED[Q] = H_to;
-      OPEN.push_front(H_to);
+    H_from = insert_config(H_from, plan[t]);
+  }
+}
+
+void Planner::apply_new_solution(const PlanDiff &diff)
+{
+  if (diff.empty()) return;
+  info(3, verbose, deadline, "incorporate new solution, changed agents: ",
+       diff.agents.size(), ", timesteps: [", diff.t_min, ", ", diff.t_max, "]");
+  auto plan = std::make_shared<const Incumbent>(*diff.base, diff);
+
+  // configurations out of [t_min, t_max] are already in EXPLORED
+  auto iter = EXPLORED.find(diff.base->get_config(diff.t_min - 1));
+  if (iter == EXPLORED.end()) {
+    apply_new_solution(plan->get_solution());  // never reached
+  } else {
+    HNode *H_from = iter->second;
+    const auto t_max = std::min(diff.t_max + 1, plan->makespan);
+    for (auto t = diff.t_min; t <= t_max; ++t) {
+      H_from = insert_config(H_from, plan->get_config(t));
     }
-    H_from = H_to;
   }
+  if (plan->loss < incumbent->loss) incumbent = plan;
+}
+
+HNode *Planner::insert_config(HNode *H_from, const Config &Q)
+{
+  HNode *H_to = nullptr;
+  auto iter = EXPLORED.find(Q);
+  if (iter != EXPLORED.end()) {
+    // known
+    H_to = iter->second;
+    rewrite(H_from, H_to, OPEN);
+  } else {
+    // new
+    H_to = create_highlevel_node(Q, H_from);
+    OPEN.push_front(H_to);
+  }
+  return H_to;
+}
+
+IncumbentPtr Planner::get_incumbent()
+{
+  if (H_goal == nullptr) return nullptr;
+  // the search may find a better solution than the snapshot
+  if (incumbent == nullptr || H_goal->g < incumbent->loss) {
+    incumbent = std::make_shared<const Incumbent>(backtrack(H_goal));
+  }
+  return incumbent;
 }
 
 Solution Planner::backtrack(HNode *H)
@@ -206,32 +490,51 @@ Solution Planner::backtrack(HNode *H)
 }
 
 bool Planner::set_new_config(HNode *H, LNode *L, Config &Q_to)
+{
+  if (use_speculation(H, L)) {
+    return get_best_config(spec.Q_cands, spec.f_vals, Q_to);
+  }
+  return set_new_config(H, L, Q_to, pibts);
+}
+
+bool Planner::set_new_config(HNode *H, LNode *L, Config &Q_to,
+                             std::vector<PIBT *> &generators)
 {
   // worker-id, time -> configuration
-  auto Q_cands = std::vector<Config>(PIBT_NUM, Config(N, nullptr));
-  auto f_vals = std::vector<int>(PIBT_NUM, INT_MAX);
+  const int K = pibt_num;  // may grow during the call
+  auto Q_cands = std::vector<Config>(K, Config(N, nullptr));
+  auto f_vals = std::vector<int>(K, INT_MAX);
 
   // parallel
   auto worker = [&](int k) {
     // set constraints
     for (auto d = 0; d < L->depth; ++d) Q_cands[k][L->who[d]] = L->where[d];
     // PIBT
-    auto res = pibts[k]->set_new_config(H->C, Q_cands[k], H->order);
+    auto res = generators[k]->set_new_config(H->C, Q_cands[k], H->order);
     if (res)
       f_vals[k] = get_edge_cost(H->C, Q_cands[k]) + heuristic->get(Q_cands[k]);
   };
-  if (FLG_MULTI_THREAD && PIBT_NUM > 1) {
-    auto threads = std::vector<std::thread>();
-    for (auto k = 0; k < PIBT_NUM; ++k) threads.emplace_back(worker, k);
-    for (auto &th : threads) th.join();
+  if (options.flg_multi_thread && K > 1) {
+    auto executor = get_executor();
+    auto group = TaskGroup();
+    for (auto k = 1; k < K; ++k) {
+      executor->submit(group, [&, k] { worker(k); }, priority);
+    }
+    worker(0);
+    executor->wait(group);
   } else {
-    for (auto k = 0; k < PIBT_NUM; ++k) worker(k);
+    for (auto k = 0; k < K; ++k) worker(k);
   }
+  return get_best_config(Q_cands, f_vals, Q_to);
+}
 
+bool Planner::get_best_config(const std::vector<Config> &Q_cands,
+                              const std::vector<int> &f_vals, Config &Q_to)
+{
   // obtain the best score
   auto min_f_val = INT_MAX;
   auto min_f_val_idx = -1;
-  for (auto k = 0; k < PIBT_NUM; ++k) {
+  for (auto k = 0; k < (int)f_vals.size(); ++k) {
     if (f_vals[k] < min_f_val) {
       min_f_val = f_vals[k];
       min_f_val_idx = k;
@@ -247,7 +550,99 @@ bool Planner::set_new_config(HNode *H, LNode *L, Config &Q_to)
   }
 }
 
-void Planner::rewrite(HNode *H_from, HNode *H_to)
+void Planner::speculate(HNode *H, const Config &Q)
+{
+  // new successor of H, starting from the root low-level node
+  const auto f = H->g + get_edge_cost(H->C, Q) + heuristic->get(Q);
+  if (H_goal != nullptr && f >= H_goal->f) {
+    speculate(nullptr);
+    return;
+  }
+  clear_speculation();
+  spec.C = Q;
+  HNode::set_priorities(Q, D, H, spec.priorities, spec.order);
+  spec.who.clear();
+  spec.where.clear();
+  launch_speculation();
+}
+
+void Planner::speculate(HNode *H)
+{
+  // known node pushed to the front of OPEN, otherwise the node expanded after
+  // discarding ones in front of OPEN by the lower bound
+  auto is_alive = [&](HNode *H_cand) {
+    return !H_cand->search_tree.empty() &&
+           (H_goal == nullptr || H_cand->f < H_goal->f);
+  };
+  if (H == nullptr || !is_alive(H)) {
+    H = nullptr;
+    for (auto k = 0; k < (int)OPEN.size() && k < SPECULATION_DEPTH; ++k) {
+      if (!is_alive(OPEN[k])) continue;
+      H = OPEN[k];
+      break;
+    }
+    if (H == nullptr) return;
+  }
+  clear_speculation();
+  auto L = H->search_tree.front();
+  spec.C = H->C;
+  spec.order = H->order;
+  spec.who = L->who;
+  spec.where = L->where;
+  launch_speculation();
+}
+
+void Planner::launch_speculation()
+{
+  const int K = pibt_num;
+  spec.Q_cands.assign(K, Config(N, nullptr));
+  spec.f_vals.assign(K, INT_MAX);
+  spec.flg_cancelled = false;
+  spec.flg_active = true;
+  auto executor = get_executor();
+  for (auto k = 0; k < K; ++k) {
+    executor->submit(
+        spec.group,
+        [&, k] {
+          if (spec.flg_cancelled) return;
+          auto &Q_cand = spec.Q_cands[k];
+          for (size_t d = 0; d < spec.who.size(); ++d) {
+            Q_cand[spec.who[d]] = spec.where[d];
+          }
+          if (pibts_spec[k]->set_new_config(spec.C, Q_cand, spec.order)) {
+            spec.f_vals[k] =
+                get_edge_cost(spec.C, Q_cand) + heuristic->get(Q_cand);
+          }
+        },
+        priority);
+  }
+}
+
+bool Planner::use_speculation(HNode *H, LNode *L)
+{
+  if (!spec.flg_active) return false;
+  // identical inputs of PIBT
+  if (L->who != spec.who || L->where != spec.where || H->C != spec.C ||
+      H->order != spec.order) {
+    clear_speculation();
+    return false;
+  }
+  get_executor()->wait(spec.group);
+  spec.flg_active = false;
+  ++spec.num_hits;
+  return true;
+}
+
+void Planner::clear_speculation()
+{
+  if (!spec.flg_active) return;
+  spec.flg_cancelled = true;
+  get_executor()->wait(spec.group);
+  spec.flg_active = false;
+  ++spec.num_misses;
+}
+
+void Planner::rewrite(HNode *H_from, HNode *H_to, std::deque<HNode *> &open)
 {
   // update neighbors
   H_from->neighbor.insert(H_to);
@@ -265,8 +660,10 @@ void Planner::rewrite(HNode *H_from, HNode *H_to)
         n_to->g = g_val;
         n_to->f = n_to->g + n_to->h;
         n_to->parent = n_from;
+        n_to->depth = n_from->depth + 1;
+        if (n_to == H_goal) f_bound = H_goal->f.load();
         Q.push(n_to);
-        if (H_goal != nullptr && n_to->f < H_goal->f) OPEN.push_front(n_to);
+        if (H_goal != nullptr && n_to->f < H_goal->f) open.push_front(n_to);
       }
     }
   }
@@ -285,90 +682,213 @@ int Planner::get_edge_cost(const Config &C1, const Config &C2)
 
 void Planner::set_scatter()
 {
-  if (!FLG_SCATTER) return;
+  // shared with PIBTs from the beginning, SUO is computed in launch_scatter
+  if (!options.flg_scatter || scatter != nullptr) return;
+  auto margin =
+      options.scatter_margin < 0 ? get_random_int(MT, 0, 30)
+                                 : options.scatter_margin;
+  // in fast-first mode, SUO is computed during refinement
+  const auto flg_async =
+      (options.flg_scatter_async || options.flg_fast_first) &&
+      options.flg_multi_thread;
+  scatter = new Scatter(ins, D, nullptr, 3, verbose - 4, margin, flg_async,
+                        options.flg_multi_thread ? options.scatter_threads : 1);
+}
+
+void Planner::launch_scatter()
+{
+  if (scatter == nullptr || !delete_scatter_after_used) return;
   info(1, verbose, deadline, "start computing SUO");
-  auto scatter_deadline =
-      Deadline(deadline == nullptr
-                   ? INT_MAX
-                   : (deadline->time_limit_ms - elapsed_ms(deadline)) / 2);
-  auto margin = SCATTER_MARGIN < 0 ? get_random_int(MT, 0, 30) : SCATTER_MARGIN;
-  scatter = new Scatter(ins, D, &scatter_deadline, 3, verbose - 4, margin);
-  scatter->construct();
-  info(1, verbose, deadline, "finish computing SUO",
-       ", collision count: ", scatter->CT.collision_cnt,
-       ", scatter margin: ", scatter->cost_margin,
-       ", sum_of_path_length: ", scatter->sum_of_path_length);
+  scatter_deadline =
+      new Deadline(deadline == nullptr
+                       ? INT_MAX
+                       : (deadline->time_limit_ms - elapsed_ms(deadline)) / 2);
+  scatter->deadline = scatter_deadline;
+  auto proc = [&]() {
+    scatter->construct();
+    info(1, verbose, deadline, "finish computing SUO",
+         ", collision count: ", scatter->CT.collision_cnt,
+         ", scatter margin: ", scatter->cost_margin,
+         ", sum_of_path_length: ", scatter->sum_of_path_length,
+         ", replans: ", scatter->num_replans, ", memory: ",
+         scatter->get_scatter_data()->memory_usage() / 1024, "KB");
+  };
+  if (scatter->flg_async) {
+    // search continues without SUO, PIBT picks up snapshots as they come
+    get_executor()->submit(scatter_group, proc, priority);
+  } else {
+    proc();
+  }
+}
+
+void Planner::clear_scatter()
+{
+  if (scatter == nullptr || !delete_scatter_after_used) return;
+  scatter->stop();
+  get_executor()->wait(scatter_group);
+}
+
+void Planner::enable_extras()
+{
+  if (!options.flg_fast_first) return;
+  info(1, verbose, deadline, "enable extras, PIBT: ", options.pibt_num,
+       ", SUO: ", scatter != nullptr);
+  clear_speculation();  // prepared with fewer generators
+  pibt_num = options.pibt_num;
+  launch_scatter();
 }
 
 void Planner::set_pibt()
 {
-  for (auto k = 0; k < PIBT_NUM; ++k) {
-    pibts.emplace_back(new PIBT(ins, D, k + seed, FLG_SWAP, scatter));
+  for (auto k = 0; k < options.pibt_num; ++k) {
+    pibts.emplace_back(new PIBT(ins, D, k + seed, options.flg_swap, scatter));
+  }
+  if (!options.flg_pipeline || !options.flg_multi_thread) return;
+  for (auto k = 0; k < options.pibt_num; ++k) {
+    pibts_spec.emplace_back(
+        new PIBT(ins, D, k + seed + options.pibt_num, options.flg_swap, scatter));
   }
 }
 
 void Planner::set_refiner()
 {
-  if (!FLG_REFINER) return;
-  if (!FLG_MULTI_THREAD) return;
-  auto plan = backtrack(H_goal);
+  // refiners keep the goals of plans, not the case in windowed planning
+  if (!options.flg_refiner || options.horizon > 0) return;
+  if (!options.flg_multi_thread) return;
+  auto plan = get_incumbent();
   info(2, verbose, deadline, "invoke refiners");
-  for (auto k = 0; k < REFINER_NUM; ++k) {
-    ++seed_refiner;
-    refiner_pool.emplace_back(
-        std::async(std::launch::async, &Planner::get_refined_plan, this, plan));
-  }
+  refiner_deadline = new Deadline(deadline, &refiner_cancel);
+  for (auto k = 0; k < options.refiner_num; ++k) launch_refiner(plan);
 }
 
-Solution Planner::get_refined_plan(const Solution &plan)
+void Planner::launch_refiner(IncumbentPtr base)
 {
-  auto MT_internal = std::mt19937(seed_refiner);
-  if (depth < 1 && plan.size() > 3 &&
-      get_random_float(MT_internal) < RECURSIVE_RATE) {
+  ++seed_refiner;
+  ++refiner_running;
+  get_executor()->submit(refiner_group, [this, base, seed = seed_refiner] {
+    refiner_results.push(get_refined_plan(base, seed));
+  });
+}
+
+void Planner::clear_refiner()
+{
+  if (refiner_running == 0) return;
+  // running refiners return their intermediate results soon
+  refiner_cancel.cancel();
+  get_executor()->wait(refiner_group);
+  for (auto &diff : refiner_results.pop_all()) apply_new_solution(diff);
+  refiner_running = 0;
+}
+
+PlanDiff Planner::get_refined_plan(IncumbentPtr base, const int seed)
+{
+  auto MT_internal = std::mt19937(seed);
+  if (depth < 1 && base->makespan > 2 &&
+      get_random_float(MT_internal) < options.recursive_rate) {
     // recursive LaCAM
-    auto ins_tmp =
-        Instance(ins->G, plan[get_random_int(MT_internal, 1, plan.size() - 2)],
-                 ins->goals, N);
-    auto deadline_tmp = Deadline(std::min(
-        RECURSIVE_TIME_LIMIT,
-        deadline == nullptr ? INT_MAX
-                            : deadline->time_limit_ms - elapsed_ms(deadline)));
+    const auto t = get_random_int(MT_internal, 1, base->makespan - 1);
+    auto ins_tmp = Instance(ins->G, base->get_config(t), ins->goals, N);
+    auto deadline_tmp = Deadline(
+        std::min(options.recursive_time_limit,
+                 deadline == nullptr
+                     ? INT_MAX
+                     : deadline->time_limit_ms - elapsed_ms(deadline)),
+        &refiner_cancel);
     auto planner_tmp =
-        Planner(&ins_tmp, 0, &deadline_tmp, seed_refiner, depth + 1, D);
+        Planner(&ins_tmp, 0, &deadline_tmp, seed, depth + 1, D, options);
     info(4, verbose, deadline, "refiner-", planner_tmp.seed,
          "\tactivated (recursive LaCAM)");
     auto res = planner_tmp.solve();
     info(4, verbose, deadline, "refiner-", planner_tmp.seed,
          "\tcompleted (recursive LaCAM)");
-    return res;
-  } else if (RECURSIVE_RATE < 1.0) {
-    // iterative refinement
-    return refine(ins, deadline, plan, D, seed_refiner, verbose - 4);
+    if (res.empty()) return PlanDiff(base);
+    // the prefix is unchanged
+    Solution plan;
+    for (auto k = 0; k < t; ++k) plan.push_back(base->get_config(k));
+    plan.insert(plan.end(), res.begin(), res.end());
+    return PlanDiff(base, plan);
+  } else if (options.recursive_rate < 1.0) {
+    // iterative refinement, by SIPP or by PIBT when SIPP stalls
+    auto session = acquire_refiner_session(seed);
+    session->sync(*base);
+    const auto flg_repair =
+        options.repair_rate > 0 && (session->flg_stalled ||
+                            get_random_float(MT_internal) < options.repair_rate);
+    auto updated = flg_repair
+                       ? session->repair(refiner_deadline, seed, priority)
+                       : session->refine(refiner_deadline, seed);
+    auto diff = session->get_diff(base, updated);
+    release_refiner_session(session);
+    return diff;
   } else {
-    return Solution();
+    return PlanDiff(base);
+  }
+}
+
+RefinerSession *Planner::acquire_refiner_session(const int seed)
+{
+  {
+    std::lock_guard<std::mutex> lock(refiner_mtx);
+    if (!refiner_sessions.empty()) {
+      auto session = refiner_sessions.back();
+      refiner_sessions.pop_back();
+      return session;
+    }
+  }
+  return new RefinerSession(ins, D, seed, verbose - 4,
+                            options.refiner_threads,
+                            options.flg_refiner_adaptive);
+}
+
+void Planner::release_refiner_session(RefinerSession *session)
+{
+  std::lock_guard<std::mutex> lock(refiner_mtx);
+  refiner_sessions.push_back(session);
+}
+
+void Planner::sync_portfolio()
+{
+  if (portfolio == nullptr) return;
+  // publish own improvement
+  if (H_goal != nullptr &&
+      (portfolio_seen == nullptr || H_goal->g < portfolio_seen->loss)) {
+    portfolio_seen = get_incumbent();
+    if (portfolio->publish(portfolio_seen, portfolio_id)) {
+      info(2, verbose, deadline, "portfolio-", portfolio_id,
+           "\tpublish solution, cost: ", portfolio_seen->loss);
+    }
   }
+  // take better one from others
+  auto best = portfolio->get();
+  if (best == nullptr || best == portfolio_seen) return;
+  portfolio_seen = best;
+  if (H_goal != nullptr && H_goal->g <= best->loss) return;
+  info(2, verbose, deadline, "portfolio-", portfolio_id,
+       "\tincorporate solution, cost: ", best->loss);
+  apply_new_solution(best->get_solution());
+}
+
+void Planner::report_improvement()
+{
+  if (!options.on_improvement || depth > 0 || portfolio_id > 0) return;
+  if (H_goal == nullptr) return;
+  if (reported != nullptr && H_goal->g >= reported->loss) return;
+  reported = get_incumbent();
+  options.on_improvement(reported, elapsed_ms(deadline));
 }
 
 void Planner::update_checkpoints()
 {
   const auto time = elapsed_ms(deadline);
-  while (time >= checkpoints.size() * CHECKPOINTS_DURATION) {
-    checkpoints.push_back(H_goal != nullptr ? H_goal->f : CHECKPOINTS_NIL);
+  while (time >= stats.checkpoints.size() * options.checkpoints_duration) {
+    const int f = f_bound;
+    stats.checkpoints.push_back(f < INT_MAX ? f : CHECKPOINTS_NIL);
   }
 }
 
 void Planner::logging()
 {
-  if (depth > 0) return;
-  MSG += "checkpoints=";
-  for (auto &k : checkpoints) MSG += std::to_string(k) + ",";
-  MSG +=
-      "\ncomp_time_initial_solution=" + std::to_string(time_initial_solution);
-  MSG += "\ncost_initial_solution=" + std::to_string(cost_initial_solution);
-  MSG += "\nsearch_iteration=" + std::to_string(search_iter);
-  MSG += "\nnum_high_level_node=" + std::to_string(HNode::COUNT);
-  MSG += "\nnum_low_level_node=" + std::to_string(LNode::COUNT);
-
+  if (depth > 0 || portfolio_id > 0) return;
   if (H_goal != nullptr && OPEN.empty()) {
     info(1, verbose, deadline, "solved optimally, cost:", H_goal->g);
   } else if (H_goal != nullptr) {
@@ -378,6 +898,10 @@ void Planner::logging()
   } else {
     info(1, verbose, deadline, "timeout");
   }
-  info(1, verbose, deadline, "search iteration:", search_iter,
+  info(1, verbose, deadline, "search iteration:", stats.search_iter,
        "\texplored:", EXPLORED.size());
+  if (!pibts_spec.empty()) {
+    info(1, verbose, deadline, "speculation hits:", spec.num_hits,
+         "\tmisses:", spec.num_misses);
+  }
 }
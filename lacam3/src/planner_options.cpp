@@ -0,0 +1,52 @@
+#include "../include/planner_options.hpp"
+
+PlannerStats::PlannerStats()
+    : num_high_level_nodes(0),
+      num_low_level_nodes(0),
+      search_iter(0),
+      time_initial_solution(-1),
+      cost_initial_solution(-1),
+      checkpoints()
+{
+}
+
+PlannerStats::PlannerStats(const PlannerStats &other) : PlannerStats()
+{
+  *this = other;
+}
+
+PlannerStats &PlannerStats::operator=(const PlannerStats &other)
+{
+  num_high_level_nodes = other.num_high_level_nodes.load();
+  num_low_level_nodes = other.num_low_level_nodes.load();
+  search_iter = other.search_iter;
+  time_initial_solution = other.time_initial_solution;
+  cost_initial_solution = other.cost_initial_solution;
+  checkpoints = other.checkpoints;
+  return *this;
+}
+
+std::string PlannerStats::get_msg() const
+{
+  std::string msg = "checkpoints=";
+  for (auto &k : checkpoints) msg += std::to_string(k) + ",";
+  msg += "\ncomp_time_initial_solution=" + std::to_string(time_initial_solution);
+  msg += "\ncost_initial_solution=" + std::to_string(cost_initial_solution);
+  msg += "\nsearch_iteration=" + std::to_string(search_iter);
+  msg += "\nnum_high_level_node=" + std::to_string(num_high_level_nodes);
+  msg += "\nnum_low_level_node=" + std::to_string(num_low_level_nodes);
+  return msg;
+}
+
+void set_num_threads(const int num_threads, const PlannerOptions &options)
+{
+  if (!options.flg_multi_thread) {
+    Executor::NUM_THREADS = 1;
+  } else if (num_threads > 0) {
+    Executor::NUM_THREADS = num_threads;
+  } else {
+    Executor::NUM_THREADS =
+        std::max((int)std::thread::hardware_concurrency(),
+                 options.flg_refiner ? options.refiner_num + 1 : 2);
+  }
+}
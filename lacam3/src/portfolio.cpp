@@ -0,0 +1,24 @@
+#include "../include/portfolio.hpp"
+
+Portfolio::Portfolio(const Deadline *deadline)
+    : mtx(),
+      incumbent(nullptr),
+      source(-1),
+      cancel(deadline == nullptr ? nullptr : deadline->cancel_token)
+{
+}
+
+bool Portfolio::publish(IncumbentPtr solution, const int id)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  if (incumbent != nullptr && incumbent->loss <= solution->loss) return false;
+  incumbent = solution;
+  source = id;
+  return true;
+}
+
+IncumbentPtr Portfolio::get()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return incumbent;
+}
@@ -1,7 +1,6 @@
 #include "../include/post_processing.hpp"
 
 #include "../include/dist_table.hpp"
-#include "../include/planner.hpp"
 
 bool is_feasible_solution(const Instance &ins, const Solution &solution,
                           const int verbose)
@@ -78,7 +77,8 @@ static const std::regex r_map_name = std::regex(R"(.+/(.+))");
 
 void make_log(const Instance &ins, const Solution &solution,
               const std::string &output_name, const double comp_time_ms,
-              const std::string &map_name, const int seed, const bool log_short)
+              const std::string &map_name, const int seed,
+              const PlannerStats &stats, const bool log_short)
 {
   // map name
   std::smatch results;
@@ -107,7 +107,7 @@ void make_log(const Instance &ins, const Solution &solution,
       << "\n";
   log << "comp_time=" << comp_time_ms << "\n";
   log << "seed=" << seed << "\n";
-  log << Planner::MSG << "\n";
+  log << stats.get_msg() << "\n";
   if (log_short) return;
   log << "starts=";
   for (size_t i = 0; i < ins.N; ++i) {
@@ -130,3 +130,37 @@ void make_log(const Instance &ins, const Solution &solution,
   }
   log.close();
 }
+
+void write_improvement(std::ostream &os, const Instance &ins,
+                       IncumbentPtr solution, IncumbentPtr prev,
+                       const double elapsed_ms)
+{
+  auto get_x = [&](int k) { return k % ins.G->width; };
+  auto get_y = [&](int k) { return k / ins.G->width; };
+  os << "elapsed=" << elapsed_ms << "\n";
+  os << "sum_of_loss=" << solution->loss << "\n";
+  os << "makespan=" << solution->makespan << "\n";
+  if (prev == nullptr) {
+    os << "solution=\n";
+    for (auto t = 0; t <= solution->makespan; ++t) {
+      os << t << ":";
+      for (auto v : solution->get_config(t)) {
+        os << "(" << get_x(v->index) << "," << get_y(v->index) << "),";
+      }
+      os << "\n";
+    }
+  } else {
+    // agent-id:path
+    os << "changed_paths=\n";
+    for (size_t i = 0; i < ins.N; ++i) {
+      auto &path = *solution->paths[i];
+      if (path == *prev->paths[i]) continue;
+      os << i << ":";
+      for (auto v : path) {
+        os << "(" << get_x(v->index) << "," << get_y(v->index) << "),";
+      }
+      os << "\n";
+    }
+  }
+  os << std::endl;
+}
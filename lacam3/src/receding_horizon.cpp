@@ -0,0 +1,58 @@
+#include "../include/receding_horizon.hpp"
+
+int plan_horizon(Graph *G, const Config &C, const Config &goals, DistTable *D,
+                 Scatter *scatter, const PlannerOptions &options,
+                 const Deadline *deadline, const int seed, const int verbose,
+                 Solution &plan)
+{
+  auto ins_tick = Instance(G, C, goals, C.size());
+  auto planner = Planner(&ins_tick, verbose, deadline, seed, 0, D, options);
+  planner.scatter = scatter;
+  planner.delete_scatter_after_used = false;
+
+  auto iter = std::find(plan.begin(), plan.end(), C);
+  if (iter != plan.end()) planner.warm_start.assign(iter, plan.end());
+
+  plan = planner.solve();
+  return std::max(0, (int)planner.warm_start.size() - 1);
+}
+
+RecedingHorizon::RecedingHorizon(const Instance *_ins,
+                                 const PlannerOptions &_options,
+                                 const int _verbose,
+                                 const Deadline *setup_deadline)
+    : ins(_ins),
+      options(_options),
+      verbose(_verbose),
+      D(new DistTable(ins)),
+      scatter(nullptr),
+      plan(),
+      num_ticks(0)
+{
+  if (!options.flg_scatter) return;
+  scatter = new Scatter(ins, D, setup_deadline, 3, verbose - 4,
+                        std::max(0, options.scatter_margin), false,
+                        options.flg_multi_thread ? options.scatter_threads : 1);
+  scatter->construct();
+  scatter->deadline = nullptr;  // read only in construct
+  info(1, verbose, setup_deadline, "SUO for receding horizon, memory: ",
+       scatter->get_scatter_data()->memory_usage() / 1024, "KB");
+}
+
+RecedingHorizon::~RecedingHorizon()
+{
+  if (scatter != nullptr) delete scatter;
+  delete D;
+}
+
+Solution RecedingHorizon::tick(const Config &C, const Deadline *deadline,
+                               int seed)
+{
+  ++num_ticks;
+  const auto num_reused = plan_horizon(ins->G, C, ins->goals, D, scatter,
+                                       options, deadline, seed, verbose - 1,
+                                       plan);
+  info(2, verbose, deadline, "tick-", num_ticks, "\tsteps: ",
+       std::max(0, (int)plan.size() - 1), ", reused: ", num_reused);
+  return plan;
+}
@@ -1,69 +1,621 @@
 #include "../include/refiner.hpp"
 
-Solution refine(const Instance *ins, const Deadline *deadline,
-                const Solution &solution, DistTable *D, const int seed,
-                const int verbose)
+Bandit::Bandit(const int num_arms, const double _reaction)
+    : weights(num_arms, 1.0), reaction(_reaction)
+{
+}
+
+int Bandit::select(std::mt19937 &MT) const
+{
+  const auto K = weights.size();
+  const auto total = std::accumulate(weights.begin(), weights.end(), 0.0);
+  const auto eps = 0.05 * total / K;  // keep exploring
+  auto r = get_random_float(MT, 0, total + eps * K);
+  for (size_t k = 0; k < K; ++k) {
+    r -= weights[k] + eps;
+    if (r <= 0) return k;
+  }
+  return K - 1;
+}
+
+void Bandit::update(const int arm, const double reward)
+{
+  weights[arm] = (1 - reaction) * weights[arm] + reaction * reward;
+}
+
+RefinerSession::RefinerSession(const Instance *_ins, DistTable *_D,
+                               const int seed, const int _verbose,
+                               const int num_threads, const bool _flg_adaptive)
+    : ins(_ins),
+      D(_D),
+      N(ins->N),
+      MT(std::mt19937(seed)),
+      verbose(_verbose),
+      paths(N),
+      synced(N, nullptr),
+      CT(ins),
+      ctx(),
+      order(N, 0),
+      old_paths(),
+      workers(),
+      num_commits(0),
+      num_rejects(0),
+      flg_adaptive(_flg_adaptive),
+      neighborhoods(),
+      bandit_generator(NB_GENERATORS),
+      bandit_size(NB_SIZES.size()),
+      goal_agents(),
+      intersections(),
+      agent_stamps(),
+      vertex_stamps(),
+      stamp(0),
+      flg_stalled(false)
 {
-  if (solution.empty()) return Solution();
-  info(0, verbose, deadline, "refiner-", seed, "\tactivated");
-  // setup
-  const auto N = ins->N;
-  auto MT = std::mt19937(seed);
-  auto paths = translateConfigsToPaths(solution);
-  auto cost_before = get_sum_of_loss_paths(paths);
-  std::vector<int> order(N, 0);
   std::iota(order.begin(), order.end(), 0);
-  auto CT = CollisionTable(ins);
-  for (auto i = 0; i < N; ++i) CT.enrollPath(i, paths[i]);
-  std::shuffle(order.begin(), order.end(), MT);
-
-  const auto num_refine_agents =
-      std::max(1, std::min(get_random_int(MT, 1, 30), int(N / 4)));
-  info(1, verbose, deadline, "refiner-", seed,
-       "\tsize of modif set: ", num_refine_agents);
-  for (auto k = 0; (k + 1) * num_refine_agents < N; ++k) {
-    if (is_expired(deadline)) return Solution();
-
-    auto old_cost = 0;
-    auto new_cost = 0;
-
-    // compute old cost
-    for (auto _i = 0; _i < num_refine_agents; ++_i) {
-      const auto i = order[k * num_refine_agents + _i];
-      old_cost += get_path_loss(paths[i]);
-      CT.clearPath(i, paths[i]);
-    }
-
-    // re-planning
-    Paths new_paths(num_refine_agents);
-    for (auto _i = 0; _i < num_refine_agents; ++_i) {
-      const auto i = order[k * num_refine_agents + _i];
-      // note: I also tested A*, but SIPP was better
-      new_paths[_i] = sipp(i, ins->starts[i], ins->goals[i], D, &CT, deadline,
-                           old_cost - new_cost - 1);
-      if (new_paths[_i].empty()) break;  // failure
-      new_cost += get_path_loss(new_paths[_i]);
-      CT.enrollPath(i, new_paths[_i]);
-    }
-
-    if (!new_paths[num_refine_agents - 1].empty() && new_cost <= old_cost) {
-      // success
-      for (auto _i = 0; _i < num_refine_agents; ++_i) {
-        const auto i = order[k * num_refine_agents + _i];
-        paths[i] = new_paths[_i];
+  for (auto k = 1; k < num_threads; ++k) {
+    workers.push_back(new RefinerSession(ins, D, seed + k));
+  }
+  if (flg_adaptive) {
+    const auto V_size = ins->G->size();
+    goal_agents.resize(V_size);
+    for (auto i = 0; i < N; ++i) goal_agents[ins->goals[i]->id].push_back(i);
+    for (auto v : ins->G->V) {
+      if (v->neighbor.size() >= 3) intersections.push_back(v->id);
+    }
+    agent_stamps.resize(N, 0);
+    vertex_stamps.resize(V_size, 0);
+  }
+}
+
+RefinerSession::~RefinerSession()
+{
+  for (auto &worker : workers) delete worker;
+}
+
+int RefinerSession::sync(const Solution &solution)
+{
+  std::vector<int> updated;
+  apply(solution, updated);
+  return updated.size();
+}
+
+void RefinerSession::apply(const Solution &solution, std::vector<int> &updated)
+{
+  if (solution.empty()) return;
+  for (auto i = 0; i < N; ++i) {
+    const auto T_i = get_path_cost(solution, i);
+    auto &path = paths[i];
+    // check diff
+    if ((int)path.size() == T_i + 1) {
+      auto t = 0;
+      while (t <= T_i && path[t] == solution[t][i]) ++t;
+      if (t > T_i) continue;
+    }
+    // replace
+    if (!path.empty()) CT.clearPath(i, path);
+    path.resize(T_i + 1);
+    for (auto t = 0; t <= T_i; ++t) path[t] = solution[t][i];
+    CT.enrollPath(i, path);
+    synced[i] = nullptr;
+    updated.push_back(i);
+  }
+  for (auto &worker : workers) worker->sync(paths, updated);
+}
+
+int RefinerSession::sync(const Incumbent &incumbent)
+{
+  std::vector<int> updated;
+  for (auto i = 0; i < N; ++i) {
+    auto &path = incumbent.paths[i];
+    if (synced[i] == path) continue;
+    synced[i] = path;
+    if (paths[i] == *path) continue;
+    set_path(i, *path);
+    updated.push_back(i);
+  }
+  for (auto &worker : workers) worker->sync(paths, updated);
+  return updated.size();
+}
+
+PlanDiff RefinerSession::get_diff(IncumbentPtr base,
+                                  const std::vector<int> &agents) const
+{
+  auto diff = PlanDiff(base);
+  for (auto i : agents) diff.add(i, paths[i]);
+  return diff;
+}
+
+int RefinerSession::sync(const Paths &_paths, const std::vector<int> &agents)
+{
+  auto cnt = 0;
+  for (auto i : agents) {
+    if (paths[i] == _paths[i]) continue;
+    set_path(i, _paths[i]);
+    ++cnt;
+  }
+  return cnt;
+}
+
+void RefinerSession::set_path(const int i, const Path &path)
+{
+  if (!paths[i].empty()) CT.clearPath(i, paths[i]);
+  paths[i] = path;
+  CT.enrollPath(i, paths[i]);
+}
+
+std::vector<int> RefinerSession::refine(const Deadline *deadline, const int id)
+{
+  if (paths.empty() || paths.front().empty()) return std::vector<int>();
+  auto updated = workers.empty() ? refine_sequential(deadline, id)
+                                 : refine_parallel(deadline, id);
+  flg_stalled = updated.empty();
+  for (auto i : updated) synced[i] = nullptr;  // diverged from the snapshot
+  return updated;
+}
+
+std::vector<int> RefinerSession::refine_sequential(const Deadline *deadline,
+                                                   const int id)
+{
+  std::vector<int> updated;
+  info(0, verbose, deadline, "refiner-", id, "\tactivated");
+  auto cost_before = get_sum_of_loss_paths(paths);
+  set_neighborhoods(deadline, id);
+  for (auto &nb : neighborhoods) {
+    if (is_expired(deadline)) break;
+    auto timer = Deadline();
+    const auto delta = replan(nb.agents, deadline);
+    reward(nb, delta, timer.elapsed_ms());
+    if (delta < 0) continue;
+    for (size_t _i = 0; _i < nb.agents.size(); ++_i) {
+      const auto i = nb.agents[_i];
+      if (paths[i] != old_paths[_i]) updated.push_back(i);
+    }
+  }
+
+  info(0, verbose, deadline, "refiner-", id, "\tsum_of_loss: ", cost_before,
+       " -> ", get_sum_of_loss_paths(paths));
+
+  std::sort(updated.begin(), updated.end());
+  updated.erase(std::unique(updated.begin(), updated.end()), updated.end());
+  return updated;
+}
+
+std::vector<int> RefinerSession::refine_parallel(const Deadline *deadline,
+                                                 const int id)
+{
+  std::vector<int> updated;
+  info(0, verbose, deadline, "refiner-", id, "\tactivated, threads: ",
+       workers.size() + 1);
+  auto cost_before = get_sum_of_loss_paths(paths);
+  set_neighborhoods(deadline, id);
+
+  // horizon for goal occupation
+  auto T = 0;
+  for (auto &path : paths) T = std::max(T, (int)path.size());
+
+  const auto K = (int)neighborhoods.size();
+  const auto batch_size = (int)workers.size() + 1;
+  std::vector<bool> done(K, false);
+  std::vector<int> batch;
+  std::unordered_set<uint64_t> occupied;
+  std::vector<uint64_t> cells;
+  auto executor = get_executor();
+  auto group = TaskGroup();
+  std::vector<int> deltas;
+  std::vector<int> touched;
+  auto k_next = 0;
+  while (k_next < K && !is_expired(deadline)) {
+    // pick disjoint neighborhoods in space-time
+    batch.clear();
+    occupied.clear();
+    for (auto k = k_next; k < K && (int)batch.size() < batch_size; ++k) {
+      if (done[k]) continue;
+      cells.clear();
+      for (auto i : neighborhoods[k].agents) get_region(i, T, cells);
+      if (std::any_of(cells.begin(), cells.end(),
+                      [&](auto c) { return occupied.count(c) > 0; })) {
+        continue;
+      }
+      occupied.insert(cells.begin(), cells.end());
+      batch.push_back(k);
+      done[k] = true;
+    }
+    while (k_next < K && done[k_next]) ++k_next;
+
+    // replan concurrently, the first one is on this session
+    auto timer = Deadline();
+    deltas.assign(batch.size(), -1);
+    for (size_t b = 1; b < batch.size(); ++b) {
+      executor->submit(group, [&, b] {
+        auto &agents = neighborhoods[batch[b]].agents;
+        deltas[b] = workers[b - 1]->replan(agents, deadline);
+      });
+    }
+    auto &agents_0 = neighborhoods[batch[0]].agents;
+    deltas[0] = replan(agents_0, deadline);
+    if (deltas[0] >= 0) {
+      for (size_t _i = 0; _i < agents_0.size(); ++_i) {
+        if (paths[agents_0[_i]] != old_paths[_i]) {
+          updated.push_back(agents_0[_i]);
+        }
+      }
+    }
+
+    // validate & commit sequentially
+    executor->wait(group);
+    for (size_t b = 1; b < batch.size(); ++b) {
+      if (deltas[b] < 0) continue;
+      auto &agents = neighborhoods[batch[b]].agents;
+      auto worker = workers[b - 1];
+      if (std::all_of(agents.begin(), agents.end(),
+                      [&](auto i) { return paths[i] == worker->paths[i]; })) {
+        continue;
+      }
+      if (commit(agents, worker->paths)) {
+        for (auto i : agents) updated.push_back(i);
+      } else {
+        deltas[b] = -1;
+      }
+    }
+    const auto time_batch = timer.elapsed_ms();
+    for (size_t b = 0; b < batch.size(); ++b) {
+      reward(neighborhoods[batch[b]], deltas[b], time_batch);
+    }
+
+    // sync replicas
+    touched.clear();
+    for (auto k : batch) {
+      auto &agents = neighborhoods[k].agents;
+      touched.insert(touched.end(), agents.begin(), agents.end());
+    }
+    for (auto &worker : workers) worker->sync(paths, touched);
+  }
+
+  info(0, verbose, deadline, "refiner-", id, "\tsum_of_loss: ", cost_before,
+       " -> ", get_sum_of_loss_paths(paths), ", commits: ", num_commits,
+       ", rejects: ", num_rejects);
+
+  std::sort(updated.begin(), updated.end());
+  updated.erase(std::unique(updated.begin(), updated.end()), updated.end());
+  return updated;
+}
+
+// loss of agents within [t0, t1], w.r.t. the original goals
+static int get_window_loss(const Solution &plan, const Config &goals,
+                           const int t0, const int t1)
+{
+  auto c = 0;
+  const auto N = goals.size();
+  for (auto t = t0 + 1; t <= t1; ++t) {
+    for (size_t i = 0; i < N; ++i) {
+      if (plan[t - 1][i] != goals[i] || plan[t][i] != goals[i]) ++c;
+    }
+  }
+  return c;
+}
+
+std::vector<int> RefinerSession::repair(const Deadline *deadline, const int id,
+                                        const TaskPriority priority)
+{
+  std::vector<int> updated;
+  flg_stalled = false;  // let SIPP retry next time
+  if (paths.empty() || paths.front().empty()) return updated;
+  auto plan = get_solution();
+  const auto T = (int)plan.size() - 1;
+  if (T < 2) return updated;
+
+  // sub-instance, boundary configurations are kept
+  const auto W =
+      std::min(T, get_random_int(MT, REPAIR_WINDOW_MIN, REPAIR_WINDOW_MAX));
+  const auto t0 = get_random_int(MT, 0, T - W);
+  const auto t1 = t0 + W;
+  auto ins_tmp = Instance(ins->G, plan[t0], plan[t1], N);
+  // agents reach their goals within W steps, farther vertices are irrelevant
+  auto D_tmp = DistTable(&ins_tmp, W + 1, priority);
+  const auto loss_before = get_window_loss(plan, ins->goals, t0, t1);
+  info(0, verbose, deadline, "refiner-", id, "\tactivated (repair), window: [",
+       t0, ", ", t1, "]");
+
+  // iterate PIBT, akin to the configuration generator of LaCAM
+  Solution best;
+  auto loss_best = loss_before;
+  std::vector<float> priorities(N);
+  std::vector<int> order(N);
+  for (auto k = 0; k < REPAIR_TRIALS && !is_expired(deadline); ++k) {
+    auto pibt = PIBT(&ins_tmp, &D_tmp, get_random_int(MT, 0, INT_MAX - 1));
+    Solution sub = {plan[t0]};
+    for (auto i = 0; i < N; ++i) {
+      priorities[i] = (float)D_tmp.get(i, plan[t0][i]) / 10000;
+    }
+    auto loss = 0;
+    while (loss < loss_best && !is_same_config(sub.back(), ins_tmp.goals)) {
+      auto &Q_from = sub.back();
+      for (auto i = 0; i < N; ++i) {
+        if (D_tmp.get(i, Q_from[i]) != 0) {
+          priorities[i] += 1;
+        } else {
+          priorities[i] -= (int)priorities[i];
+        }
+      }
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [&](int i, int j) { return priorities[i] > priorities[j]; });
+      auto Q_to = Config(N, nullptr);
+      if (!pibt.set_new_config(Q_from, Q_to, order)) break;
+      for (auto i = 0; i < N; ++i) {
+        if (Q_from[i] != ins->goals[i] || Q_to[i] != ins->goals[i]) ++loss;
       }
+      sub.push_back(Q_to);
+    }
+    if (loss < loss_best && is_same_config(sub.back(), ins_tmp.goals)) {
+      best = std::move(sub);
+      loss_best = loss;
+    }
+  }
+
+  if (!best.empty()) {
+    // splice
+    Solution plan_new(plan.begin(), plan.begin() + t0);
+    plan_new.insert(plan_new.end(), best.begin(), best.end());
+    plan_new.insert(plan_new.end(), plan.begin() + t1 + 1, plan.end());
+    apply(plan_new, updated);
+  }
+  info(0, verbose, deadline, "refiner-", id, "\twindow loss: ", loss_before,
+       " -> ", loss_best);
+  return updated;
+}
+
+int RefinerSession::replan(const std::vector<int> &agents,
+                           const Deadline *deadline)
+{
+  const auto M = agents.size();
+  if (old_paths.size() < M) old_paths.resize(M);
+  auto old_cost = 0;
+  auto new_cost = 0;
+
+  // compute old cost
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    old_cost += get_path_loss(paths[i]);
+    CT.clearPath(i, paths[i]);
+    std::swap(paths[i], old_paths[_i]);
+    paths[i].clear();
+  }
+
+  // re-planning
+  auto success = true;
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    // note: I also tested A*, but SIPP was better
+    paths[i] = sipp(i, ins->starts[i], ins->goals[i], D, &CT, deadline,
+                    old_cost - new_cost - 1, &ctx);
+    if (paths[i].empty()) {  // failure
+      success = false;
+      break;
+    }
+    new_cost += get_path_loss(paths[i]);
+    CT.enrollPath(i, paths[i]);
+  }
+  if (success && new_cost <= old_cost) return old_cost - new_cost;
+
+  // rollback
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    if (!paths[i].empty()) CT.clearPath(i, paths[i]);
+    std::swap(paths[i], old_paths[_i]);
+    CT.enrollPath(i, paths[i]);
+  }
+  return -1;
+}
+
+bool RefinerSession::commit(const std::vector<int> &agents,
+                            const Paths &new_paths)
+{
+  const auto M = agents.size();
+  if (old_paths.size() < M) old_paths.resize(M);
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    CT.clearPath(i, paths[i]);
+    std::swap(paths[i], old_paths[_i]);
+  }
+  const auto cnt = CT.collision_cnt;
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    paths[i] = new_paths[i];
+    CT.enrollPath(i, paths[i]);
+  }
+  if (CT.collision_cnt <= cnt) {
+    ++num_commits;
+    return true;
+  }
+
+  // conflicts with another neighborhood
+  for (size_t _i = 0; _i < M; ++_i) {
+    const auto i = agents[_i];
+    CT.clearPath(i, paths[i]);
+    std::swap(paths[i], old_paths[_i]);
+    CT.enrollPath(i, paths[i]);
+  }
+  ++num_rejects;
+  return false;
+}
+
+void RefinerSession::set_neighborhoods(const Deadline *deadline, const int id)
+{
+  neighborhoods.clear();
+  if (!flg_adaptive) {
+    // chunks of a random order with a random size
+    std::shuffle(order.begin(), order.end(), MT);
+    const auto num_refine_agents =
+        std::max(1, std::min(get_random_int(MT, 1, 30), int(N / 4)));
+    info(1, verbose, deadline, "refiner-", id,
+         "\tsize of modif set: ", num_refine_agents);
+    for (auto k = 0; (k + 1) * num_refine_agents < N; ++k) {
+      neighborhoods.push_back(
+          {std::vector<int>(order.begin() + k * num_refine_agents,
+                            order.begin() + (k + 1) * num_refine_agents),
+           -1, -1});
+    }
+    return;
+  }
+
+  // generate neighborhoods until all agents are covered in expectation
+  for (auto cnt = 0; cnt < N;) {
+    auto nb = Neighborhood{std::vector<int>(), bandit_generator.select(MT),
+                           bandit_size.select(MT)};
+    const auto size = std::max(1, std::min(NB_SIZES[nb.size_arm], N / 4));
+    if (nb.generator == NB_AGENT) {
+      get_agent_neighborhood(size, nb.agents);
+    } else if (nb.generator == NB_INTERSECTION) {
+      get_intersection_neighborhood(size, nb.agents);
     } else {
-      // failure
-      for (auto _i = 0; _i < num_refine_agents; ++_i) {
-        const auto i = order[k * num_refine_agents + _i];
-        if (!new_paths[_i].empty()) CT.clearPath(i, new_paths[_i]);
-        CT.enrollPath(i, paths[i]);
+      get_random_neighborhood(size, nb.agents);
+    }
+    cnt += size;
+    neighborhoods.push_back(std::move(nb));
+  }
+  info(1, verbose, deadline, "refiner-", id,
+       "\tweights of generators: ", bandit_generator, ", sizes: ", bandit_size);
+}
+
+void RefinerSession::reward(const Neighborhood &nb, const int delta,
+                            const double time_ms)
+{
+  if (nb.generator < 0) return;
+  const auto r = std::max(delta, 0) / std::max(time_ms, 0.01);
+  bandit_generator.update(nb.generator, r);
+  bandit_size.update(nb.size_arm, r);
+}
+
+bool RefinerSession::add_agent(const int i, const int size,
+                               std::vector<int> &agents)
+{
+  if ((int)agents.size() >= size) return true;
+  if (agent_stamps[i] != stamp) {
+    agent_stamps[i] = stamp;
+    agents.push_back(i);
+  }
+  return (int)agents.size() >= size;
+}
+
+void RefinerSession::get_random_neighborhood(const int size,
+                                             std::vector<int> &agents)
+{
+  // partial Fisher-Yates
+  for (auto k = 0; k < size; ++k) {
+    std::swap(order[k], order[get_random_int(MT, k, N - 1)]);
+    agents.push_back(order[k]);
+  }
+}
+
+void RefinerSession::get_agent_neighborhood(const int size,
+                                            std::vector<int> &agents)
+{
+  ++stamp;
+  // seed, the most delayed agent among a few samples
+  auto i_seed = 0;
+  auto delay_max = -1;
+  for (auto k = 0; k < 8; ++k) {
+    const auto i = get_random_int(MT, 0, N - 1);
+    const auto delay = get_path_loss(paths[i]) - D->get(i, ins->starts[i]);
+    if (delay > delay_max) {
+      i_seed = i;
+      delay_max = delay;
+    }
+  }
+  add_agent(i_seed, size, agents);
+
+  // expand with agents near the paths in space-time
+  for (size_t q = 0; q < agents.size() && (int)agents.size() < size; ++q) {
+    auto &path = paths[agents[q]];
+    const auto T_i = (int)path.size() - 1;
+    for (auto t = 0; t <= T_i && (int)agents.size() < size; ++t) {
+      // agents passing the same vertex around t, i.e., potential blockers
+      const auto v_id = path[t]->id;
+      for (auto t_j = std::max(0, t - 2); t_j <= t + 2; ++t_j) {
+        CT.for_each_agent(v_id, t_j,
+                          [&](int j) { add_agent(j, size, agents); });
+      }
+      for (auto j : goal_agents[v_id]) {
+        if ((int)paths[j].size() <= t + 3) add_agent(j, size, agents);
       }
     }
   }
+  while (!add_agent(get_random_int(MT, 0, N - 1), size, agents));
+}
 
-  info(0, verbose, deadline, "refiner-", seed, "\tsum_of_loss: ", cost_before,
-       " -> ", get_sum_of_loss_paths(paths));
+void RefinerSession::get_intersection_neighborhood(const int size,
+                                                   std::vector<int> &agents)
+{
+  ++stamp;
+  auto s = ins->G->V[intersections.empty()
+                         ? get_random_int(MT, 0, ins->G->size() - 1)
+                         : intersections[get_random_int(
+                               MT, 0, intersections.size() - 1)]];
+
+  // collect agents visiting vertices around the intersection
+  std::vector<Vertex *> OPEN = {s};
+  vertex_stamps[s->id] = stamp;
+  for (size_t q = 0; q < OPEN.size() && (int)agents.size() < size; ++q) {
+    auto v = OPEN[q];
+    const auto T = CT.get_horizon(v->id);
+    for (auto t = 0; t < T && (int)agents.size() < size; ++t) {
+      CT.for_each_agent(v->id, t, [&](int j) { add_agent(j, size, agents); });
+    }
+    for (auto j : goal_agents[v->id]) add_agent(j, size, agents);
+    for (auto u : v->neighbor) {
+      if (vertex_stamps[u->id] == stamp) continue;
+      vertex_stamps[u->id] = stamp;
+      OPEN.push_back(u);
+    }
+  }
+  while (!add_agent(get_random_int(MT, 0, N - 1), size, agents));
+}
+
+void RefinerSession::get_region(const int i, const int T,
+                                std::vector<uint64_t> &cells) const
+{
+  const auto width = (ins->G->width + REGION_CELL_SIZE - 1) / REGION_CELL_SIZE;
+  auto get_cell = [&](const Vertex *v, const int t) {
+    const uint64_t block =
+        v->y / REGION_CELL_SIZE * width + v->x / REGION_CELL_SIZE;
+    return (block << 32) | (t / REGION_TIME_SIZE);
+  };
+  auto &path = paths[i];
+  const auto T_i = (int)path.size() - 1;
+  for (auto t = 0; t < T + REGION_TIME_SIZE;
+       t += (t < T_i ? 1 : REGION_TIME_SIZE)) {
+    const auto c = get_cell(path[std::min(t, T_i)], t);
+    if (cells.empty() || cells.back() != c) cells.push_back(c);
+  }
+}
 
+Solution RefinerSession::get_solution() const
+{
   return translatePathsToConfigs(paths);
 }
+
+Solution refine(const Instance *ins, const Deadline *deadline,
+                const Solution &solution, DistTable *D, const int seed,
+                const int verbose)
+{
+  if (solution.empty()) return Solution();
+  auto session = RefinerSession(ins, D, seed, verbose);
+  session.sync(solution);
+  session.refine(deadline, seed);
+  return session.get_solution();
+}
+
+std::ostream &operator<<(std::ostream &os, const Bandit &bandit)
+{
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+  os << std::fixed << std::setprecision(2);
+  for (size_t k = 0; k < bandit.weights.size(); ++k) {
+    if (k > 0) os << ",";
+    os << bandit.weights[k];
+  }
+  os.flags(flags);
+  os.precision(precision);
+  return os;
+}
@@ -3,7 +3,8 @@
 #include "../include/metrics.hpp"
 
 Scatter::Scatter(const Instance *_ins, DistTable *_D, const Deadline *_deadline,
-                 const int seed, int _verbose, int _cost_margin)
+                 const int seed, int _verbose, int _cost_margin,
+                 bool _flg_async, int _num_threads)
     : ins(_ins),
       deadline(_deadline),
       MT(std::mt19937(seed)),
@@ -14,8 +15,12 @@ Scatter::Scatter(const Instance *_ins, DistTable *_D, const Deadline *_deadline,
       D(_D),
       cost_margin(_cost_margin),
       sum_of_path_length(0),
+      flg_async(_flg_async),
+      num_threads(std::max(1, _num_threads)),
+      num_replans(0),
+      flg_stop(false),
       paths(N),
-      scatter_data(N),
+      scatter_data(nullptr),
       CT(ins)
 {
 }
@@ -24,19 +29,9 @@ void Scatter::construct()
 {
   info(0, verbose, deadline, "scatter", "\tinvoked");
 
-  // define path finding utilities
-  // vertex, cost-to-come, cost-to-go, collision, parent
-  using ScatterNode = std::tuple<Vertex *, int, int, int, Vertex *>;
-  auto cmp = [&](ScatterNode &a, ScatterNode &b) {
-    // collision
-    if (std::get<3>(a) != std::get<3>(b))
-      return std::get<3>(a) > std::get<3>(b);
-    auto f_a = std::get<1>(a) + std::get<2>(a);
-    auto f_b = std::get<1>(b) + std::get<2>(b);
-    if (f_a != f_b) return f_a > f_b;
-    return std::get<0>(a)->id < std::get<0>(b)->id;
-  };
-  auto CLOSED = std::vector<Vertex *>(V_size, nullptr);  // parent
+  // parent, one for each worker
+  auto CLOSEDs = std::vector<std::vector<Vertex *>>(
+      num_threads, std::vector<Vertex *>(V_size, nullptr));
 
   // metrics
   auto collision_cnt_last = 0;
@@ -53,95 +48,228 @@ void Scatter::construct()
     std::iota(order.begin(), order.end(), 0);
     std::shuffle(order.begin(), order.end(), MT);
 
-    // single-agent path finding for agent-i
-    for (int _i = 0; _i < N; ++_i) {
-      if (is_expired(deadline)) break;
+    if (num_threads > 1) {
+      construct_parallel(order, CLOSEDs);
+    } else {
+      construct_sequential(order, CLOSEDs[0]);
+    }
 
-      const auto i = order[_i];
-      const auto cost_ub = D->get(i, ins->starts[i]) + cost_margin;
+    paths_prev = paths;
+    info(1, verbose, deadline, "scatter", "\titer:", loop,
+         "\tcollision_cnt:", CT.collision_cnt);
 
-      if (!paths[i].empty()) sum_of_path_length -= (paths[i].size() - 1);
+    if (CT.collision_cnt == 0) break;
+    if (is_stopped()) break;
+    if (flg_async) publish();  // intermediate result
+  }
 
-      // clear cache
-      CT.clearPath(i, paths[i]);
+  paths = paths_prev;
+  publish();
+  CT.shrink();
 
-      // setup A*
-      auto OPEN = std::priority_queue<ScatterNode, std::vector<ScatterNode>,
-                                      decltype(cmp)>(cmp);
-      // used with CLOSED, vertex-id list
-      const auto s_i = ins->starts[i];
-      OPEN.push(std::make_tuple(s_i, 0, D->get(i, s_i), 0, nullptr));
-      auto USED = std::vector<int>();
-
-      // A*
-      auto solved = false;
-      while (!OPEN.empty() && !is_expired(deadline)) {
-        // pop
-        auto node = OPEN.top();
-        OPEN.pop();
-
-        // check CLOSED list
-        const auto v = std::get<0>(node);
-        const auto g_v = std::get<1>(node);  // cost-to-come
-        const auto c_v = std::get<3>(node);  // collision
-        if (CLOSED[v->id] != nullptr) continue;
-        CLOSED[v->id] = std::get<4>(node);  // parent
-        USED.push_back(v->id);
-
-        // check goal condition
-        if (v == ins->goals[i]) {
-          solved = true;
-          break;
-        }
-
-        // expand
-        for (auto u : v->neighbor) {
-          auto d_u = D->get(i, u);
-          if (u != s_i && CLOSED[u->id] == nullptr &&
-              d_u + g_v + 1 <= cost_ub) {
-            // insert new node
-            OPEN.push(std::make_tuple(u, g_v + 1, d_u,
-                                      CT.getCollisionCost(v, u, g_v) + c_v, v));
-          }
-        }
-      }
+  info(0, verbose, deadline, "scatter", "\tcompleted");
+}
+
+void Scatter::construct_sequential(const std::vector<int> &order,
+                                   std::vector<Vertex *> &CLOSED)
+{
+  for (int _i = 0; _i < N; ++_i) {
+    if (is_stopped()) break;
+    const auto i = order[_i];
+    if (!paths[i].empty()) sum_of_path_length -= (paths[i].size() - 1);
+    CT.clearPath(i, paths[i]);
+    find_path(i, CLOSED, paths[i]);
+    // register to CT & update collision count
+    CT.enrollPath(i, paths[i]);
+    sum_of_path_length += paths[i].size() - 1;
+  }
+}
 
-      // backtrack
-      if (solved) {
-        paths[i].clear();
-        auto v = ins->goals[i];
-        while (v != nullptr) {
-          paths[i].push_back(v);
-          v = CLOSED[v->id];
-        }
-        std::reverse(paths[i].begin(), paths[i].end());
+void Scatter::construct_parallel(const std::vector<int> &order,
+                                 std::vector<std::vector<Vertex *>> &CLOSEDs)
+{
+  const int batch_size = num_threads * BATCH_SIZE_PER_THREAD;
+  auto new_paths = std::vector<Path>(batch_size);
+  auto collisions = std::vector<int>(batch_size, -1);
+
+  for (int k_s = 0; k_s < N; k_s += batch_size) {
+    if (is_stopped()) break;
+    const auto k_e = std::min(N, k_s + batch_size);
+
+    // plan concurrently against the frozen CT, ignoring own old paths
+    auto worker = [&](int w) {
+      for (auto k = k_s + w; k < k_e; k += num_threads) {
+        auto &path = new_paths[k - k_s];
+        path.clear();
+        collisions[k - k_s] = find_path(order[k], CLOSEDs[w], path, true);
       }
+    };
+    auto executor = get_executor();
+    auto group = TaskGroup();
+    for (auto w = 1; w < num_threads; ++w) {
+      executor->submit(group, [&, w] { worker(w); }, PRIORITY_HIGH);
+    }
+    worker(0);
+    executor->wait(group);
 
-      // register to CT & update collision count
+    // commit in order, replanning agents whose commits raced
+    for (auto k = k_s; k < k_e; ++k) {
+      const auto i = order[k];
+      auto &path = new_paths[k - k_s];
+      if (!paths[i].empty()) sum_of_path_length -= (paths[i].size() - 1);
+      CT.clearPath(i, paths[i]);
+      if (collisions[k - k_s] >= 0 &&
+          get_collision_cost(path) > collisions[k - k_s]) {
+        ++num_replans;
+        path.clear();
+        find_path(i, CLOSEDs[0], path);
+      }
+      if (!path.empty()) paths[i] = path;
       CT.enrollPath(i, paths[i]);
       sum_of_path_length += paths[i].size() - 1;
+    }
+  }
+}
 
-      // memory management
-      for (auto k : USED) CLOSED[k] = nullptr;
+int Scatter::find_path(const int i, std::vector<Vertex *> &CLOSED, Path &path,
+                       bool flg_ignore_self)
+{
+  const auto ignored = flg_ignore_self ? i : -1;
+  // vertex, cost-to-come, cost-to-go, collision, parent
+  using ScatterNode = std::tuple<Vertex *, int, int, int, Vertex *>;
+  auto cmp = [&](ScatterNode &a, ScatterNode &b) {
+    // collision
+    if (std::get<3>(a) != std::get<3>(b))
+      return std::get<3>(a) > std::get<3>(b);
+    auto f_a = std::get<1>(a) + std::get<2>(a);
+    auto f_b = std::get<1>(b) + std::get<2>(b);
+    if (f_a != f_b) return f_a > f_b;
+    return std::get<0>(a)->id < std::get<0>(b)->id;
+  };
+
+  const auto cost_ub = D->get(i, ins->starts[i]) + cost_margin;
+
+  // setup A*
+  auto OPEN =
+      std::priority_queue<ScatterNode, std::vector<ScatterNode>, decltype(cmp)>(
+          cmp);
+  // used with CLOSED, vertex-id list
+  const auto s_i = ins->starts[i];
+  OPEN.push(std::make_tuple(s_i, 0, D->get(i, s_i), 0, nullptr));
+  auto USED = std::vector<int>();
+
+  // A*
+  auto collision = -1;
+  while (!OPEN.empty() && !is_stopped()) {
+    // pop
+    auto node = OPEN.top();
+    OPEN.pop();
+
+    // check CLOSED list
+    const auto v = std::get<0>(node);
+    const auto g_v = std::get<1>(node);  // cost-to-come
+    const auto c_v = std::get<3>(node);  // collision
+    if (CLOSED[v->id] != nullptr) continue;
+    CLOSED[v->id] = std::get<4>(node);  // parent
+    USED.push_back(v->id);
+
+    // check goal condition
+    if (v == ins->goals[i]) {
+      collision = c_v;
+      break;
     }
 
-    paths_prev = paths;
-    info(1, verbose, deadline, "scatter", "\titer:", loop,
-         "\tcollision_cnt:", CT.collision_cnt);
+    // expand
+    for (auto u : v->neighbor) {
+      auto d_u = D->get(i, u);
+      if (u != s_i && CLOSED[u->id] == nullptr && d_u + g_v + 1 <= cost_ub) {
+        // insert new node
+        OPEN.push(std::make_tuple(u, g_v + 1, d_u,
+                                  CT.getCollisionCost(v, u, g_v, ignored) + c_v,
+                                  v));
+      }
+    }
+  }
 
-    if (CT.collision_cnt == 0) break;
-    if (is_expired(deadline)) break;
+  // backtrack
+  if (collision >= 0) {
+    path.clear();
+    auto v = ins->goals[i];
+    while (v != nullptr) {
+      path.push_back(v);
+      v = CLOSED[v->id];
+    }
+    std::reverse(path.begin(), path.end());
   }
 
-  paths = paths_prev;
+  // memory management
+  for (auto k : USED) CLOSED[k] = nullptr;
+  return collision;
+}
 
-  // set scatter data
-  for (auto i = 0; i < N; ++i) {
-    if (paths[i].empty()) continue;
-    for (auto t = 0; t < paths[i].size() - 1; ++t) {
-      scatter_data[i][paths[i][t]->id] = paths[i][t + 1];
+int Scatter::get_collision_cost(const Path &path)
+{
+  auto collision = 0;
+  for (auto t = 1; t < (int)path.size(); ++t) {
+    collision += CT.getCollisionCost(path[t - 1], path[t], t - 1);
+  }
+  return collision;
+}
+
+void Scatter::publish()
+{
+  std::atomic_store(&scatter_data, std::shared_ptr<const ScatterData>(
+                                       std::make_shared<ScatterData>(paths)));
+}
+
+std::shared_ptr<const ScatterData> Scatter::get_scatter_data() const
+{
+  return std::atomic_load(&scatter_data);
+}
+
+void Scatter::stop() { flg_stop = true; }
+
+bool Scatter::is_stopped() const { return flg_stop || is_expired(deadline); }
+
+ScatterData::ScatterData(const std::vector<Path> &paths)
+    : offsets(paths.size() + 1, 0), keys(), values()
+{
+  auto size = 0;
+  for (auto &path : paths) size += std::max(0, (int)path.size() - 1);
+  keys.reserve(size);
+  values.reserve(size);
+
+  // vertex-id, timestep
+  auto entries = std::vector<std::pair<int, int>>();
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto &path = paths[i];
+    entries.clear();
+    for (auto t = 0; t + 1 < (int)path.size(); ++t) {
+      entries.emplace_back(path[t]->id, t);
     }
+    std::sort(entries.begin(), entries.end());
+    for (size_t k = 0; k < entries.size(); ++k) {
+      // revisited vertex -> the latest one
+      if (k + 1 < entries.size() && entries[k + 1].first == entries[k].first)
+        continue;
+      keys.push_back(entries[k].first);
+      values.push_back(path[entries[k].second + 1]);
+    }
+    offsets[i + 1] = keys.size();
   }
+}
 
-  info(0, verbose, deadline, "scatter", "\tcompleted");
+Vertex *ScatterData::get(const int i, const int v_id) const
+{
+  auto first = keys.begin() + offsets[i];
+  auto last = keys.begin() + offsets[i + 1];
+  auto itr = std::lower_bound(first, last, v_id);
+  if (itr == last || *itr != v_id) return nullptr;
+  return values[itr - keys.begin()];
+}
+
+size_t ScatterData::memory_usage() const
+{
+  return offsets.capacity() * sizeof(int) + keys.capacity() * sizeof(int) +
+         values.capacity() * sizeof(Vertex *);
 }
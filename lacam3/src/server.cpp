@@ -0,0 +1,231 @@
+#include "../include/server.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cstring>
+
+#include "../include/lacam.hpp"
+
+namespace protocol
+{
+
+static bool read_all(int fd, void *buf, size_t size)
+{
+  auto p = static_cast<char *>(buf);
+  while (size > 0) {
+    auto n = ::recv(fd, p, size, 0);
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool write_all(int fd, const void *buf, size_t size)
+{
+  auto p = static_cast<const char *>(buf);
+  while (size > 0) {
+    auto n = ::send(fd, p, size, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool read_ints(int fd, std::vector<int32_t> &arr, const int32_t size)
+{
+  arr.resize(size);
+  return read_all(fd, arr.data(), size * sizeof(int32_t));
+}
+
+bool read_request(int fd, Request &req)
+{
+  int32_t header[5];
+  if (!read_all(fd, header, sizeof(header))) return false;
+  if (header[0] != MAGIC || header[2] < 0 || header[2] > MAX_AGENTS) {
+    return false;
+  }
+  req.map_id = header[1];
+  req.time_limit_ms = header[3];
+  req.seed = header[4];
+  return read_ints(fd, req.starts, header[2]) &&
+         read_ints(fd, req.goals, header[2]);
+}
+
+bool write_request(int fd, const Request &req)
+{
+  // buffered, a request is sent in one go
+  if (req.goals.size() != req.starts.size()) return false;
+  const int32_t N = req.starts.size();
+  auto buf = std::vector<int32_t>{MAGIC, req.map_id, N, req.time_limit_ms,
+                                  req.seed};
+  buf.insert(buf.end(), req.starts.begin(), req.starts.end());
+  buf.insert(buf.end(), req.goals.begin(), req.goals.end());
+  return write_all(fd, buf.data(), buf.size() * sizeof(int32_t));
+}
+
+bool read_response(int fd, Response &res)
+{
+  int32_t header[5];
+  if (!read_all(fd, header, sizeof(header))) return false;
+  if (header[0] != MAGIC || header[3] < 0 || header[4] < 0) return false;
+  res.status = header[1];
+  res.comp_time_ms = header[2];
+  res.solution.resize(header[3]);
+  for (auto &Q : res.solution) {
+    if (!read_ints(fd, Q, header[4])) return false;
+  }
+  return true;
+}
+
+bool write_response(int fd, const Response &res)
+{
+  const int32_t N = res.solution.empty() ? 0 : res.solution[0].size();
+  auto buf = std::vector<int32_t>{MAGIC, res.status, res.comp_time_ms,
+                                  (int32_t)res.solution.size(), N};
+  for (auto &Q : res.solution) buf.insert(buf.end(), Q.begin(), Q.end());
+  return write_all(fd, buf.data(), buf.size() * sizeof(int32_t));
+}
+
+static bool set_address(const std::string &socket_path, sockaddr_un &addr)
+{
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) return false;
+  std::strcpy(addr.sun_path, socket_path.c_str());
+  return true;
+}
+
+int connect(const std::string &socket_path)
+{
+  sockaddr_un addr;
+  if (!set_address(socket_path, addr)) return -1;
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (::connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+}  // namespace protocol
+
+Server::Server(const std::string &_socket_path,
+               const std::vector<SolverSession *> &_sessions,
+               const int _verbose, const int _max_time_limit_ms)
+    : socket_path(_socket_path),
+      sessions(_sessions),
+      verbose(_verbose),
+      max_time_limit_ms(_max_time_limit_ms),
+      listen_fd(-1),
+      flg_stop(false),
+      cancel(),
+      mtx(),
+      cv_closed(),
+      client_fds()
+{
+}
+
+Server::~Server()
+{
+  if (listen_fd < 0) return;
+  ::close(listen_fd);
+  ::unlink(socket_path.c_str());
+}
+
+bool Server::open()
+{
+  sockaddr_un addr;
+  if (!protocol::set_address(socket_path, addr)) {
+    info(0, verbose, "socket path is too long: ", socket_path);
+    return false;
+  }
+  listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) return false;
+  ::unlink(socket_path.c_str());
+  if (::bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+      ::listen(listen_fd, SOMAXCONN) < 0) {
+    info(0, verbose, "failed to listen on ", socket_path, ": ",
+         std::strerror(errno));
+    ::close(listen_fd);
+    listen_fd = -1;
+    return false;
+  }
+  return true;
+}
+
+void Server::run()
+{
+  info(1, verbose, "listening on ", socket_path, ", maps: ", sessions.size());
+  while (!flg_stop) {
+    auto fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      break;  // stopped
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    client_fds.insert(fd);
+    std::thread(&Server::serve, this, fd).detach();
+  }
+
+  // wake up connections waiting for requests, running ones are cancelled
+  std::unique_lock<std::mutex> lock(mtx);
+  for (auto fd : client_fds) ::shutdown(fd, SHUT_RDWR);
+  cv_closed.wait(lock, [&] { return client_fds.empty(); });
+}
+
+void Server::stop()
+{
+  flg_stop = true;
+  cancel.cancel();
+  if (listen_fd >= 0) ::shutdown(listen_fd, SHUT_RDWR);
+}
+
+void Server::serve(int fd)
+{
+  auto req = protocol::Request();
+  while (!flg_stop && protocol::read_request(fd, req)) {
+    auto res = handle(req);
+    if (!protocol::write_response(fd, res)) break;
+  }
+  std::lock_guard<std::mutex> lock(mtx);
+  ::close(fd);
+  client_fds.erase(fd);
+  cv_closed.notify_all();
+}
+
+protocol::Response Server::handle(const protocol::Request &req)
+{
+  const auto deadline =
+      Deadline(std::min(req.time_limit_ms, max_time_limit_ms), &cancel);
+  auto res = protocol::Response{protocol::INVALID, 0, {}};
+  if (req.map_id < 0 || req.map_id >= (int)sessions.size() ||
+      req.time_limit_ms <= 0) {
+    info(1, verbose, &deadline, "invalid request, map_id: ", req.map_id,
+         ", time_limit_ms: ", req.time_limit_ms);
+    return res;
+  }
+  auto session = sessions[req.map_id];
+  auto starts = Config();
+  auto goals = Config();
+  for (auto k : req.starts) starts.push_back(session->get_vertex(k));
+  for (auto k : req.goals) goals.push_back(session->get_vertex(k));
+  if (!session->is_valid(starts, goals)) {
+    info(1, verbose, &deadline, "invalid locations, map_id: ", req.map_id);
+    return res;
+  }
+  auto solution = session->solve(starts, goals, &deadline, req.seed);
+  res.status = solution.empty() ? protocol::FAILURE : protocol::SUCCESS;
+  res.comp_time_ms = deadline.elapsed_ms();
+  for (auto &Q : solution) {
+    auto &row = res.solution.emplace_back();
+    for (auto v : Q) row.push_back(v->index);
+  }
+  info(2, verbose, &deadline, "map-", req.map_id, "\tagents: ",
+       req.starts.size(), ", status: ", res.status, ", makespan: ",
+       (int)solution.size() - 1);
+  return res;
+}
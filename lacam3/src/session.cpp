@@ -0,0 +1,64 @@
+#include "../include/session.hpp"
+
+#include "../include/lacam.hpp"
+
+SolverSession::SolverSession(const std::string &map_filename,
+                             const PlannerOptions &_options,
+                             const int _verbose,
+                             const size_t dist_cache_capacity)
+    : G(new Graph(map_filename)),
+      dist_cache(G, dist_cache_capacity),
+      options(_options),
+      verbose(_verbose),
+      num_requests(0)
+{
+}
+
+SolverSession::~SolverSession() { delete G; }
+
+Vertex *SolverSession::get_vertex(const int index) const
+{
+  if (index < 0 || index >= (int)G->U.size()) return nullptr;
+  return G->U[index];
+}
+
+bool SolverSession::is_valid(const Config &starts, const Config &goals) const
+{
+  if (starts.empty() || starts.size() != goals.size()) return false;
+  // duplicates cannot be solved, or collide from the beginning
+  auto is_distinct = [&](const Config &C) {
+    auto used = std::vector<bool>(G->U.size(), false);
+    for (auto v : C) {
+      if (v == nullptr || used[v->index]) return false;
+      used[v->index] = true;
+    }
+    return true;
+  };
+  return is_distinct(starts) && is_distinct(goals);
+}
+
+Solution SolverSession::solve(const std::vector<int> &start_indexes,
+                              const std::vector<int> &goal_indexes,
+                              const Deadline *deadline, int seed,
+                              PlannerStats *stats)
+{
+  auto starts = Config();
+  auto goals = Config();
+  for (auto k : start_indexes) starts.push_back(get_vertex(k));
+  for (auto k : goal_indexes) goals.push_back(get_vertex(k));
+  return solve(starts, goals, deadline, seed, stats);
+}
+
+Solution SolverSession::solve(const Config &starts, const Config &goals,
+                              const Deadline *deadline, int seed,
+                              PlannerStats *stats)
+{
+  ++num_requests;
+  if (!is_valid(starts, goals)) {
+    info(1, verbose, deadline, "invalid locations, check request");
+    return {};
+  }
+  const auto ins = Instance(G, starts, goals, starts.size());
+  auto D = DistTable(&ins, &dist_cache);
+  return ::solve(ins, verbose, deadline, seed, options, stats, &D);
+}
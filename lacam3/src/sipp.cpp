@@ -1,39 +1,7 @@
 #include "../include/sipp.hpp"
 
-SITable::SITable(CollisionTable *_CT) : CT(_CT) {}
-
-SITable::~SITable() {}
-
-SIs &SITable::get(Vertex *v)
-{
-  auto &b_v = body[v->id];
-  if (!b_v.empty()) return b_v;
-  auto &entry = CT->body[v->id];
-  auto &entry_last = CT->body_last[v->id];
-  auto t_last = entry_last.empty()
-                    ? INT_MAX
-                    : *std::min_element(entry_last.begin(), entry_last.end());
-
-  // insert safe interval
-  auto time_start = 0;
-  for (auto t = 0; t < entry.size(); ++t) {
-    if (entry[t].empty()) continue;
-    auto time_end = t - 1;
-    if (time_start <= time_end) {
-      b_v.push_back(std::make_pair(time_start, time_end));
-    }
-    time_start = t + 1;
-    if (t_last == t) break;
-  }
-  // add last safe interval
-  if (t_last == INT_MAX) {
-    b_v.push_back(std::make_pair(time_start, INT_MAX - 1));
-  }
-  return b_v;
-}
-
 SINode::SINode(const int _uuid, const SI &si, Vertex *_v, int _t, int _g,
-               int _f, SINode *_parent)
+               int _f, int _parent)
     : uuid(_uuid),
       time_start(si.first),
       time_end(si.second),
@@ -45,124 +13,235 @@ SINode::SINode(const int _uuid, const SI &si, Vertex *_v, int _t, int _g,
 {
 }
 
-bool SINode::operator==(const SINode &other) const
+static constexpr int SIPP_TABLE_INIT_SIZE = 1024;  // power of two
+
+SIPPContext::SIPPContext()
+    : nodes(), states(), table(SIPP_TABLE_INIT_SIZE, Slot{0, -1, 0}), heap(),
+      stamp(0)
 {
-  return (other.v->id == v->id && other.time_start == time_start &&
-          other.time_end == time_end);
 }
 
-uint SINodeHasher::operator()(const SINode &n) const
+void SIPPContext::reset()
 {
-  uint hash = n.v->id;
-  hash ^= n.time_start + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-  hash ^= n.time_end + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-  return hash;
+  nodes.clear();
+  states.clear();
+  heap.clear();
+  // invalidate the table in O(1), except when the stamp wraps around
+  if (++stamp == 0) {
+    std::fill(table.begin(), table.end(), Slot{0, -1, 0});
+    stamp = 1;
+  }
+}
+
+static inline size_t get_slot(const uint64_t key, const size_t mask)
+{
+  return (key * 0x9e3779b97f4a7c15ULL >> 32) & mask;
+}
+
+int SIPPContext::get_state(const uint64_t key)
+{
+  const auto mask = table.size() - 1;
+  for (auto k = get_slot(key, mask);; k = (k + 1) & mask) {
+    auto &slot = table[k];
+    if (slot.stamp != stamp) return -1;
+    if (slot.key == key) return slot.state;
+  }
+}
+
+int SIPPContext::add_state(const uint64_t key, const int node)
+{
+  if ((states.size() + 1) * 2 > table.size()) grow();
+  const auto s = (int)states.size();
+  states.push_back(State{node, -1});
+  const auto mask = table.size() - 1;
+  auto k = get_slot(key, mask);
+  while (table[k].stamp == stamp) k = (k + 1) & mask;
+  table[k] = Slot{key, s, stamp};
+  return s;
+}
+
+void SIPPContext::grow()
+{
+  auto table_old = std::move(table);
+  table = std::vector<Slot>(table_old.size() * 2, Slot{0, -1, 0});
+  const auto mask = table.size() - 1;
+  for (auto &slot : table_old) {
+    if (slot.stamp != stamp) continue;
+    auto k = get_slot(slot.key, mask);
+    while (table[k].stamp == stamp) k = (k + 1) & mask;
+    table[k] = slot;
+  }
+}
+
+bool SIPPContext::is_prior(const int s1, const int s2) const
+{
+  auto &a = nodes[states[s1].node];
+  auto &b = nodes[states[s2].node];
+  if (a.f != b.f) return a.f < b.f;
+  if (a.g != b.g) return a.g > b.g;
+  if (a.time_start != b.time_start) return a.time_start < b.time_start;
+  return a.uuid > b.uuid;
+}
+
+void SIPPContext::push(const int s)
+{
+  states[s].heap_pos = heap.size();
+  heap.push_back(s);
+  sift_up(heap.size() - 1);
+}
+
+int SIPPContext::pop()
+{
+  const auto s = heap.front();
+  states[s].heap_pos = -1;
+  heap.front() = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    states[heap.front()].heap_pos = 0;
+    sift_down(0);
+  }
+  return s;
+}
+
+void SIPPContext::update(const int s) { sift_up(states[s].heap_pos); }
+
+void SIPPContext::sift_up(int k)
+{
+  const auto s = heap[k];
+  while (k > 0) {
+    const auto k_parent = (k - 1) / 2;
+    if (!is_prior(s, heap[k_parent])) break;
+    heap[k] = heap[k_parent];
+    states[heap[k]].heap_pos = k;
+    k = k_parent;
+  }
+  heap[k] = s;
+  states[s].heap_pos = k;
+}
+
+void SIPPContext::sift_down(int k)
+{
+  const auto s = heap[k];
+  const int size = heap.size();
+  while (true) {
+    auto k_child = 2 * k + 1;
+    if (k_child >= size) break;
+    if (k_child + 1 < size && is_prior(heap[k_child + 1], heap[k_child]))
+      ++k_child;
+    if (!is_prior(heap[k_child], s)) break;
+    heap[k] = heap[k_child];
+    states[heap[k]].heap_pos = k;
+    k = k_child;
+  }
+  heap[k] = s;
+  states[s].heap_pos = k;
+}
+
+// vertex-id & index of safe interval
+static inline uint64_t get_key(const Vertex *v, const int k)
+{
+  return ((uint64_t)v->id << 32) | (uint32_t)k;
 }
 
 // minimizing path-loss - not cost!
 Path sipp(const int i, Vertex *s_i, Vertex *g_i, DistTable *D,
-          CollisionTable *CT, const Deadline *deadline, const int f_upper_bound)
+          CollisionTable *CT, const Deadline *deadline, const int f_upper_bound,
+          SIPPContext *ctx)
 {
+  thread_local SIPPContext ctx_default;
+  if (ctx == nullptr) ctx = &ctx_default;
+  ctx->reset();
+  auto &nodes = ctx->nodes;
+  auto &states = ctx->states;
+
   auto solution_path = Path();
-  auto ST = SITable(CT);  // safe interval table
 
   // setup goal
-  auto &intervals_goal = ST.get(g_i);
+  auto intervals_goal = CT->get_safe_intervals(g_i->id);
   if (intervals_goal.empty()) return solution_path;
   const auto t_goal_after = intervals_goal.back().first - 1;
 
   // setup OPEN lists
-  auto cmpNodes = [&](SINode *a, SINode *b) {
-    if (a->f != b->f) return a->f > b->f;
-    if (a->g != b->g) return a->g < b->g;
-    if (a->time_start != b->time_start) return a->time_start > b->time_start;
-    return a->uuid < b->uuid;
-  };
-
-  int node_id = 0;
-  auto OPEN =
-      std::priority_queue<SINode *, SINodes, decltype(cmpNodes)>(cmpNodes);
-  std::unordered_map<SINode, SINode *, SINodeHasher> EXPLORED;
-  OPEN.push(new SINode(++node_id, ST.get(s_i)[0], s_i, 0, 0, D->get(i, s_i),
-                       nullptr));
+  nodes.emplace_back(0, CT->get_safe_intervals(s_i->id)[0], s_i, 0, 0,
+                     D->get(i, s_i), -1);
+  ctx->push(ctx->add_state(get_key(s_i, 0), 0));
 
   // main loop
-  while (!OPEN.empty() && !is_expired(deadline)) {
-    auto n = OPEN.top();
-    OPEN.pop();
-
-    // check known node
-    auto itr_e = EXPLORED.find(*n);
-    if (itr_e != EXPLORED.end() && itr_e->second->g <= n->g) {
-      delete n;
-      continue;
-    }
-    EXPLORED[*n] = n;
+  while (!ctx->heap.empty() && !is_expired(deadline)) {
+    auto n_id = states[ctx->pop()].node;
 
     // goal check
-    if (n->v == g_i && n->t > t_goal_after) {
+    if (nodes[n_id].v == g_i && nodes[n_id].t > t_goal_after) {
       // backtrack
-      auto t = n->t;
+      auto t = nodes[n_id].t;
       while (t >= 0) {
-        solution_path.push_back(n->v);
-        if (t == n->t) n = n->parent;
+        solution_path.push_back(nodes[n_id].v);
+        if (t == nodes[n_id].t) n_id = nodes[n_id].parent;
         --t;
       }
       std::reverse(solution_path.begin(), solution_path.end());
       break;
     }
 
+    // note: nodes may be reallocated in the loop
+    auto n_v = nodes[n_id].v;
+    const auto n_t = nodes[n_id].t;
+    const auto n_g = nodes[n_id].g;
+    const auto n_time_start = nodes[n_id].time_start;
+    const auto n_time_end = nodes[n_id].time_end;
+
     // expand neighbors
-    for (auto &u : n->v->neighbor) {
-      for (auto &si : ST.get(u)) {
+    const auto K = n_v->neighbor.size();
+    for (size_t k_u = 0; k_u < K; ++k_u) {
+      auto u = n_v->neighbor[k_u];
+      auto intervals = CT->get_safe_intervals(u->id);
+      for (auto k = 0; k < intervals.size(); ++k) {
+        auto &si = intervals[k];
         // invalid transition
-        if (si.first > n->time_end + 1) break;
-        if (si.second <= n->time_start) continue;
-
-        // check existence of t
-        auto t_earliest = INT_MAX;
-        if (n->v != g_i) {
-          for (auto t = std::max(n->t, si.first - 1);
-               t <= std::min(n->time_end, si.second - 1); ++t) {
-            if (CT->getCollisionCost(n->v, u, t) == 0) {
-              t_earliest = t + 1;
-              break;
-            }
-          }
-        } else {
-          // for goal node -> reverse
-          for (auto t = std::min(n->time_end, si.second - 1);
-               t >= std::max(n->t, si.first - 1); --t) {
-            if (CT->getCollisionCost(n->v, u, t) == 0) {
-              t_earliest = t + 1;
-              break;
-            }
-          }
-        }
+        if (si.first > n_time_end + 1) break;
+        if (si.second <= n_time_start) continue;
+
+        // check existence of t, i.e., departure without swap conflicts;
+        // vertex & goal collisions are excluded by the safe interval
+        const auto t_lo = std::max(n_t, si.first - 1);
+        const auto t_hi = std::min(n_time_end, si.second - 1);
+        const auto t_departure =
+            (n_v != g_i)
+                ? CT->get_earliest_departure(n_v, k_u, t_lo, t_hi)
+                : CT->get_latest_departure(n_v, k_u, t_lo, t_hi);  // goal
+        const auto t_earliest = (t_departure < 0) ? INT_MAX : t_departure + 1;
         if (t_earliest >= INT_MAX) continue;
 
         // valid neighbor
-        auto g_val = n->g + (n->v != g_i ? t_earliest - n->t : 1);
+        auto g_val = n_g + (n_v != g_i ? t_earliest - n_t : 1);
         auto f_val = g_val + D->get(i, u);
-        auto n_new = new SINode(++node_id, si, u, t_earliest, g_val, f_val, n);
+        if (f_val > f_upper_bound) continue;
 
-        auto itr = EXPLORED.find(*n_new);
-        if (f_val > f_upper_bound ||
-            (itr != EXPLORED.end() && g_val >= itr->second->g)) {
-          delete n_new;
+        // check known node
+        const auto key = get_key(u, k);
+        auto s = ctx->get_state(key);
+        if (s != -1) {
+          const auto g_known = nodes[states[s].node].g;
+          // expanded -> strictly better only, in OPEN -> latest one
+          if (g_val > g_known) continue;
+          if (g_val == g_known && states[s].heap_pos == -1) continue;
+        }
+        const int m_id = nodes.size();
+        nodes.emplace_back(m_id, si, u, t_earliest, g_val, f_val, n_id);
+        if (s == -1) {
+          ctx->push(ctx->add_state(key, m_id));
         } else {
-          OPEN.push(n_new);
+          states[s].node = m_id;
+          if (states[s].heap_pos == -1) {
+            ctx->push(s);
+          } else {
+            ctx->update(s);
+          }
         }
       }
     }
   }
 
-  // memory management
-  while (!OPEN.empty()) {
-    delete OPEN.top();
-    OPEN.pop();
-  }
-  for (auto iter : EXPLORED) delete iter.second;
   return solution_path;
 }
 
@@ -2,8 +2,32 @@
 
 void info(const int level, const int verbose) { std::cout << std::endl; }
 
-Deadline::Deadline(double _time_limit_ms)
-    : t_s(Time::now()), time_limit_ms(_time_limit_ms)
+CancelToken::CancelToken(const CancelToken *_parent)
+    : flg_cancelled(false), parent(_parent)
+{
+}
+
+void CancelToken::cancel() { flg_cancelled = true; }
+
+bool CancelToken::is_cancelled() const
+{
+  for (auto token = this; token != nullptr; token = token->parent) {
+    if (token->flg_cancelled.load(std::memory_order_relaxed)) return true;
+  }
+  return false;
+}
+
+Deadline::Deadline(double _time_limit_ms, const CancelToken *_cancel_token)
+    : t_s(Time::now()),
+      time_limit_ms(_time_limit_ms),
+      cancel_token(_cancel_token)
+{
+}
+
+Deadline::Deadline(const Deadline *base, const CancelToken *_cancel_token)
+    : t_s(base == nullptr ? Time::now() : base->t_s),
+      time_limit_ms(base == nullptr ? INT_MAX : base->time_limit_ms),
+      cancel_token(_cancel_token)
 {
 }
 
@@ -35,6 +59,10 @@ double elapsed_ns(const Deadline *deadline)
 bool is_expired(const Deadline *deadline)
 {
   if (deadline == nullptr) return false;
+  if (deadline->cancel_token != nullptr &&
+      deadline->cancel_token->is_cancelled()) {
+    return true;
+  }
   return deadline->elapsed_ms() > deadline->time_limit_ms;
 }
 
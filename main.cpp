@@ -26,6 +26,13 @@ int main(int argc, char *argv[])
   program.add_argument("-l", "--log_short")
       .default_value(false)
       .implicit_value(true);
+  program.add_argument("--stream")
+      .help("file receiving each improved solution as soon as it is found")
+      .default_value(std::string(""));
+  program.add_argument("--stream-diff")
+      .help("write only changed paths after the first solution in --stream")
+      .default_value(false)
+      .implicit_value(true);
 
   // solver parameters
   program.add_argument("--no-all")
@@ -36,6 +43,10 @@ int main(int argc, char *argv[])
       .help("turn off the anytime part, i.e., usual LaCAM")
       .default_value(false)
       .implicit_value(true);
+  program.add_argument("--fast-first")
+      .help("vanilla LaCAM until the initial solution, then other options")
+      .default_value(false)
+      .implicit_value(true);
   program.add_argument("--random-insert-prob1")
       .help("probability of inserting the start node")
       .default_value(std::string("0.001"));
@@ -54,13 +65,34 @@ int main(int argc, char *argv[])
       .help("turn off multi-threading")
       .default_value(false)
       .implicit_value(true);
+  program.add_argument("--threads")
+      .help("total number of solver threads, 0 -> hardware concurrency but "
+            "at least one for each refiner and one for the search")
+      .default_value(std::string("0"));
   program.add_argument("--pibt-num")
       .help("used in Monte-Carlo configuration generation")
       .default_value(std::string("10"));
+  program.add_argument("--pipeline")
+      .help("expand the next node speculatively during bookkeeping")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--searchers")
+      .help("number of concurrent high-level searchers")
+      .default_value(std::string("1"));
+  program.add_argument("--portfolio")
+      .help("number of planners with diverse parameters sharing solutions")
+      .default_value(std::string("1"));
   program.add_argument("--no-scatter")
       .help("turn off SUO")
       .default_value(false)
       .implicit_value(true);
+  program.add_argument("--scatter-async")
+      .help("compute SUO in background while searching")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--scatter-threads")
+      .help("number of threads for path construction in SUO")
+      .default_value(std::string("1"));
   program.add_argument("--scatter-margin")
       .help("allowing non-shortest paths in SUO")
       .default_value(std::string("10"));
@@ -71,6 +103,17 @@ int main(int argc, char *argv[])
   program.add_argument("--refiner-num")
       .help("specify the number of refiners")
       .default_value(std::string("4"));
+  program.add_argument("--refiner-threads")
+      .help("number of threads cooperating in each refiner")
+      .default_value(std::string("1"));
+  program.add_argument("--refiner-adaptive")
+      .help("select neighborhoods of refiners adaptively")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--repair-rate")
+      .help("rate of PIBT-based window repair in refiners, also used when "
+            "SIPP stalls; 0 -> off")
+      .default_value(std::string("0"));
   program.add_argument("--recursive-rate")
       .help("specify the rate of the recursive call of LaCAM")
       .default_value(std::string("0.2"));
@@ -104,38 +147,70 @@ int main(int argc, char *argv[])
 
   // solver parameters
   const auto flg_no_all = program.get<bool>("no-all");
-  // Planner::FLG_SWAP = !program.get<bool>("no-swap") && !flg_no_all;
-  Planner::FLG_SWAP = true;
-  Planner::FLG_STAR = !program.get<bool>("no-star") && !flg_no_all;
-  Planner::FLG_MULTI_THREAD =
+  auto options = PlannerOptions();
+  // options.flg_swap = !program.get<bool>("no-swap") && !flg_no_all;
+  options.flg_swap = true;
+  options.flg_star = !program.get<bool>("no-star") && !flg_no_all;
+  options.flg_fast_first = program.get<bool>("fast-first");
+  options.flg_multi_thread =
       !program.get<bool>("no-multi-thread") && !flg_no_all;
-  Planner::PIBT_NUM =
+  options.pibt_num =
       flg_no_all ? 1 : std::stoi(program.get<std::string>("pibt-num"));
-  Planner::FLG_REFINER = !program.get<bool>("no-refiner") && !flg_no_all;
-  Planner::REFINER_NUM = std::stoi(program.get<std::string>("refiner-num"));
-  Planner::FLG_SCATTER = !program.get<bool>("no-scatter") && !flg_no_all;
-  Planner::SCATTER_MARGIN =
+  options.flg_pipeline = program.get<bool>("pipeline");
+  options.searcher_num = std::stoi(program.get<std::string>("searchers"));
+  options.portfolio_num = std::stoi(program.get<std::string>("portfolio"));
+  options.flg_refiner = !program.get<bool>("no-refiner") && !flg_no_all;
+  options.refiner_num = std::stoi(program.get<std::string>("refiner-num"));
+  // must be set before the first use, i.e., computing the distance table
+  set_num_threads(std::stoi(program.get<std::string>("threads")), options);
+  options.refiner_threads =
+      std::stoi(program.get<std::string>("refiner-threads"));
+  options.flg_refiner_adaptive = program.get<bool>("refiner-adaptive");
+  options.repair_rate = std::stof(program.get<std::string>("repair-rate"));
+  options.flg_scatter = !program.get<bool>("no-scatter") && !flg_no_all;
+  options.flg_scatter_async = program.get<bool>("scatter-async");
+  options.scatter_threads =
+      std::stoi(program.get<std::string>("scatter-threads"));
+  options.scatter_margin =
       std::stoi(program.get<std::string>("scatter-margin"));
-  Planner::RANDOM_INSERT_PROB1 =
+  options.random_insert_prob1 =
       flg_no_all ? 0
                  : std::stof(program.get<std::string>("random-insert-prob1"));
-  Planner::RANDOM_INSERT_PROB2 =
+  options.random_insert_prob2 =
       flg_no_all ? 0
                  : std::stof(program.get<std::string>("random-insert-prob2"));
-  Planner::FLG_RANDOM_INSERT_INIT_NODE =
+  options.flg_random_insert_init_node =
       program.get<bool>("random-insert-init-node") && !flg_no_all;
-  Planner::RECURSIVE_RATE =
+  options.recursive_rate =
       flg_no_all ? 0 : std::stof(program.get<std::string>("recursive-rate"));
-  Planner::RECURSIVE_TIME_LIMIT =
+  options.recursive_time_limit =
       flg_no_all
           ? 0
           : std::stof(program.get<std::string>("recursive-time-limit")) * 1000;
-  Planner::CHECKPOINTS_DURATION =
+  options.checkpoints_duration =
       std::stof(program.get<std::string>("checkpoints-duration")) * 1000;
 
+  // anytime output
+  const auto stream_name = program.get<std::string>("stream");
+  const auto flg_stream_diff = program.get<bool>("stream-diff");
+  std::ofstream stream;
+  IncumbentPtr streamed = nullptr;
+  auto num_streamed = 0;
+  if (!stream_name.empty()) {
+    stream.open(stream_name, std::ios::out);
+    options.on_improvement = [&](IncumbentPtr solution, double elapsed_ms) {
+      stream << "improvement=" << ++num_streamed << "\n";
+      write_improvement(stream, ins, solution,
+                        flg_stream_diff ? streamed : nullptr, elapsed_ms);
+      streamed = solution;
+    };
+  }
+
   // solve
   const auto deadline = Deadline(time_limit_sec * 1000);
-  const auto solution = solve(ins, verbose - 1, &deadline, seed);
+  auto stats = PlannerStats();
+  const auto solution =
+      solve(ins, verbose - 1, &deadline, seed, options, &stats);
   const auto comp_time_ms = deadline.elapsed_ms();
 
   // failure
@@ -149,6 +224,7 @@ int main(int argc, char *argv[])
 
   // post processing
   print_stats(verbose, &deadline, ins, solution, comp_time_ms);
-  make_log(ins, solution, output_name, comp_time_ms, map_name, seed, log_short);
+  make_log(ins, solution, output_name, comp_time_ms, map_name, seed, stats,
+           log_short);
   return 0;
 }
@@ -0,0 +1,189 @@
+"""
+Thin ctypes binding of the C ABI (lacam3/include/lacam3.h).
+
+Solutions are exposed without copies as memoryviews of shape (T, N), e.g.,
+numpy.asarray(solution.paths) shares the solver-owned buffer.
+
+usage:
+    session = lacam3.Session("assets/random-32-32-10.map", star=False)
+    solution = session.solve(starts, goals, time_limit_ms=1000)
+    if solution.status == lacam3.SUCCESS:
+        solution.paths[t, i]  # grid index (width * y + x) of agent i at t
+
+The shared library is searched in $LACAM3_LIBRARY, then build/lacam3/.
+"""
+
+import ctypes
+import os
+
+SUCCESS = 0
+FAILURE = 1
+INVALID = 2
+BUFFER_TOO_SMALL = 3
+
+API_VERSION = 1
+
+
+class Options(ctypes.Structure):
+    _fields_ = [
+        ("struct_size", ctypes.c_int32),
+        ("flg_star", ctypes.c_int32),
+        ("flg_multi_thread", ctypes.c_int32),
+        ("pibt_num", ctypes.c_int32),
+        ("flg_scatter", ctypes.c_int32),
+        ("flg_refiner", ctypes.c_int32),
+        ("refiner_num", ctypes.c_int32),
+        ("random_insert_prob1", ctypes.c_double),
+        ("random_insert_prob2", ctypes.c_double),
+        ("recursive_rate", ctypes.c_double),
+    ]
+
+
+def _load_library():
+    path = os.environ.get("LACAM3_LIBRARY")
+    if path is None:
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        path = os.path.join(root, "build", "lacam3", "liblacam3.so")
+    lib = ctypes.CDLL(path)
+    i32, p_i32 = ctypes.c_int32, ctypes.POINTER(ctypes.c_int32)
+    p_options, p = ctypes.POINTER(Options), ctypes.c_void_p
+    signatures = {
+        "lacam3_api_version": (i32, []),
+        "lacam3_options_init_sized": (None, [p_options, i32]),
+        "lacam3_set_num_threads": (None, [i32]),
+        "lacam3_session_create": (p, [ctypes.c_char_p, p_options]),
+        "lacam3_session_destroy": (None, [p]),
+        "lacam3_session_width": (i32, [p]),
+        "lacam3_session_height": (i32, [p]),
+        "lacam3_solve": (p, [p, p_i32, p_i32, i32, i32, i32]),
+        "lacam3_solution_status": (i32, [p]),
+        "lacam3_solution_T": (i32, [p]),
+        "lacam3_solution_N": (i32, [p]),
+        "lacam3_solution_data": (p_i32, [p]),
+        "lacam3_solution_sum_of_loss": (i32, [p]),
+        "lacam3_solution_comp_time_ms": (ctypes.c_double, [p]),
+        "lacam3_solution_free": (None, [p]),
+        "lacam3_solve_into": (
+            i32, [p, p_i32, p_i32, i32, i32, i32, p_i32, i32, p_i32]
+        ),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        func = getattr(lib, name)
+        func.restype = restype
+        func.argtypes = argtypes
+    if lib.lacam3_api_version() != API_VERSION:
+        raise RuntimeError(f"{path}: unsupported API version")
+    return lib
+
+
+_lib = None
+
+
+def _get_library():
+    global _lib
+    if _lib is None:
+        _lib = _load_library()
+    return _lib
+
+
+def set_num_threads(num_threads):
+    """total solver threads of the process, before the first solve"""
+    _get_library().lacam3_set_num_threads(num_threads)
+
+
+def _int32_array(values):
+    values = list(values)
+    return (ctypes.c_int32 * len(values))(*values), len(values)
+
+
+class _Handle:
+    """solver-owned solution, freed when neither Solution nor views remain"""
+
+    def __init__(self, handle):
+        self.handle = handle
+
+    def __del__(self):
+        if _lib is not None:
+            _lib.lacam3_solution_free(self.handle)
+
+
+class Solution:
+    def __init__(self, handle):
+        lib = _get_library()
+        self._handle = _Handle(handle)
+        self.status = lib.lacam3_solution_status(handle)
+        self.T = lib.lacam3_solution_T(handle)
+        self.N = lib.lacam3_solution_N(handle)
+        self.sum_of_loss = lib.lacam3_solution_sum_of_loss(handle)
+        self.comp_time_ms = lib.lacam3_solution_comp_time_ms(handle)
+        self.paths = None
+        if self.T > 0 and self.N > 0:
+            ptr = lib.lacam3_solution_data(handle)
+            buf = (ctypes.c_int32 * (self.T * self.N)).from_address(
+                ctypes.addressof(ptr.contents)
+            )
+            buf._owner = self._handle
+            self.paths = memoryview(buf).cast("B").cast("i", (self.T, self.N))
+
+
+class Session:
+    """map & distances kept across solve calls"""
+
+    def __init__(self, map_filename, star=True, multi_thread=True,
+                 pibt_num=None, scatter=True, refiner=True, refiner_num=None):
+        lib = _get_library()
+        options = Options()
+        lib.lacam3_options_init_sized(
+            ctypes.byref(options), ctypes.sizeof(options)
+        )
+        options.flg_star = int(star)
+        options.flg_multi_thread = int(multi_thread)
+        options.flg_scatter = int(scatter)
+        options.flg_refiner = int(refiner)
+        if pibt_num is not None:
+            options.pibt_num = pibt_num
+        if refiner_num is not None:
+            options.refiner_num = refiner_num
+        self._handle = lib.lacam3_session_create(
+            map_filename.encode(), ctypes.byref(options)
+        )
+        if self._handle is None:
+            raise FileNotFoundError(map_filename)
+        self.width = lib.lacam3_session_width(self._handle)
+        self.height = lib.lacam3_session_height(self._handle)
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None and _lib is not None:
+            _lib.lacam3_session_destroy(self._handle)
+            self._handle = None
+
+    def solve(self, starts, goals, time_limit_ms=1000, seed=0):
+        starts, N = _int32_array(starts)
+        goals, N_goals = _int32_array(goals)
+        if N != N_goals:
+            raise ValueError("starts and goals differ in length")
+        handle = _get_library().lacam3_solve(
+            self._handle, starts, goals, N, time_limit_ms, seed
+        )
+        if handle is None:
+            raise MemoryError()
+        return Solution(handle)
+
+    def solve_into(self, starts, goals, buf, time_limit_ms=1000, seed=0):
+        """
+        buf: writable int32 buffer of max_T x N, e.g., a numpy array;
+        returns (status, T), only the first max_T steps are written
+        """
+        starts, N = _int32_array(starts)
+        goals, N_goals = _int32_array(goals)
+        if N != N_goals:
+            raise ValueError("starts and goals differ in length")
+        view = memoryview(buf).cast("B")
+        max_T = len(view) // (4 * N) if N > 0 else 0
+        c_buf = (ctypes.c_int32 * (len(view) // 4)).from_buffer(view)
+        T = ctypes.c_int32(0)
+        status = _get_library().lacam3_solve_into(
+            self._handle, starts, goals, N, time_limit_ms, seed,
+            c_buf, max_T, ctypes.byref(T),
+        )
+        return status, T.value
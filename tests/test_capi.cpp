@@ -0,0 +1,99 @@
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <lacam.hpp>
+#include <lacam3.h>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 20);
+    auto starts = std::vector<int32_t>();
+    auto goals = std::vector<int32_t>();
+    for (auto v : ins.starts) starts.push_back(v->index);
+    for (auto v : ins.goals) goals.push_back(v->index);
+    const int32_t N = ins.N;
+
+    assert(lacam3_api_version() == LACAM3_API_VERSION);
+    assert(lacam3_session_create("../assets/none.map", nullptr) == nullptr);
+    lacam3_options options;
+    lacam3_options_init(&options);
+    assert(options.pibt_num == PlannerOptions().pibt_num);
+    assert(options.struct_size == sizeof(lacam3_options));
+
+    // callers compiled with an older header, fields beyond are untouched
+    lacam3_options options_old;
+    std::memset(&options_old, 0xff, sizeof(options_old));
+    const int32_t size_old = offsetof(lacam3_options, pibt_num);
+    lacam3_options_init_sized(&options_old, size_old);
+    assert(options_old.struct_size == size_old);
+    assert(options_old.flg_star == PlannerOptions().flg_star);
+    assert(options_old.pibt_num == -1);
+    auto session_old = lacam3_session_create(map_filename, &options_old);
+    assert(session_old != nullptr);
+    lacam3_session_destroy(session_old);
+    options.flg_star = 0;
+    auto session = lacam3_session_create(map_filename, &options);
+    assert(session != nullptr);
+    assert(lacam3_session_width(session) == 32);
+
+    // solver-owned buffer
+    auto sol = lacam3_solve(session, starts.data(), goals.data(), N, 1000, 0);
+    assert(lacam3_solution_status(sol) == LACAM3_SUCCESS);
+    const auto T = lacam3_solution_T(sol);
+    assert(T > 0 && lacam3_solution_N(sol) == N);
+    auto data = lacam3_solution_data(sol);
+    auto solution = Solution(T);
+    for (auto t = 0; t < T; ++t) {
+      for (auto i = 0; i < N; ++i) {
+        solution[t].push_back(ins.G->U[data[t * N + i]]);
+      }
+    }
+    assert(is_feasible_solution(ins, solution));
+    assert(lacam3_solution_sum_of_loss(sol) == get_sum_of_loss(solution));
+
+    // caller-provided buffer, prefix only when it is short
+    auto buf = std::vector<int32_t>(T * N, -1);
+    auto T_full = 0;
+    auto status = lacam3_solve_into(session, starts.data(), goals.data(), N,
+                                    1000, 0, buf.data(), T, &T_full);
+    assert(status == LACAM3_SUCCESS && T_full == T);
+    assert(std::equal(buf.begin(), buf.end(), data));
+    std::fill(buf.begin(), buf.end(), -1);
+    status = lacam3_solve_into(session, starts.data(), goals.data(), N, 1000,
+                               0, buf.data(), 2, &T_full);
+    assert(status == LACAM3_BUFFER_TOO_SMALL && T_full == T);
+    assert(std::equal(buf.begin(), buf.begin() + 2 * N, data));
+    assert(buf[2 * N] == -1);
+    lacam3_solution_free(sol);
+
+    // invalid, duplicated starts or goals
+    for (auto arr : {&starts, &goals}) {
+      auto backup = (*arr)[1];
+      (*arr)[1] = (*arr)[0];
+      sol = lacam3_solve(session, starts.data(), goals.data(), N, 1000, 0);
+      assert(lacam3_solution_status(sol) == LACAM3_INVALID);
+      lacam3_solution_free(sol);
+      (*arr)[1] = backup;
+    }
+    goals[0] = -1;
+    sol = lacam3_solve(session, starts.data(), goals.data(), N, 1000, 0);
+    assert(lacam3_solution_status(sol) == LACAM3_INVALID);
+    assert(lacam3_solution_T(sol) == 0);
+    lacam3_solution_free(sol);
+
+    // no agents
+    sol = lacam3_solve(session, nullptr, nullptr, 0, 500, 0);
+    assert(lacam3_solution_status(sol) == LACAM3_INVALID);
+    assert(lacam3_solution_T(sol) == 0 && lacam3_solution_N(sol) == 0);
+    lacam3_solution_free(sol);
+    status = lacam3_solve_into(session, starts.data(), goals.data(), 0, 500, 0,
+                               buf.data(), T, &T_full);
+    assert(status == LACAM3_INVALID && T_full == 0);
+    lacam3_session_destroy(session);
+  }
+
+  return 0;
+}
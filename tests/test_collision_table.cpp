@@ -0,0 +1,141 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto map_filename = "../assets/empty-8-8.map";
+    const auto ins = Instance(map_filename, std::vector<int>({0, 8}),
+                              std::vector<int>({9, 1}));
+    auto &U = ins.G->U;
+    auto CT = CollisionTable(&ins);
+
+    // vertex collision
+    auto path0 = Path({U[0], U[1], U[2]});
+    auto path1 = Path({U[9], U[1], U[10]});
+    CT.enrollPath(0, path0);
+    CT.enrollPath(1, path1);
+    assert(CT.collision_cnt == 1);
+    assert(CT.get_agents_num(U[1]->id, 1) == 2);
+    assert(CT.getCollisionCost(U[0], U[1], 0) == 2);
+    assert(CT.getCollisionCost(U[0], U[1], 0, 0) == 1);
+    CT.clearPath(1, path1);
+    assert(CT.collision_cnt == 0);
+
+    // edge collision
+    auto path2 = Path({U[1], U[0], U[8]});
+    CT.enrollPath(1, path2);
+    assert(CT.collision_cnt == 1);
+    CT.clearPath(1, path2);
+    assert(CT.collision_cnt == 0);
+
+    // goal collision
+    auto path3 = Path({U[5], U[4], U[3], U[2], U[10]});
+    CT.enrollPath(1, path3);
+    assert(CT.collision_cnt == 1);
+    assert(CT.get_first_goal_arrival(U[2]->id) == 2);
+    assert(CT.get_goal_arrivals_before(U[2]->id, 3) == 1);
+    CT.clearPath(1, path3);
+    CT.clearPath(0, path0);
+    assert(CT.collision_cnt == 0);
+    assert(CT.get_first_goal_arrival(U[2]->id) == INT_MAX);
+
+    // compaction
+    assert(CT.get_horizon(U[0]->id) == 0);
+    assert(CT.get_safe_intervals(U[0]->id).size() == 1);
+    assert(CT.get_horizon(U[2]->id) == 0);
+  }
+
+  {
+    // safe intervals
+    const auto map_filename = "../assets/empty-8-8.map";
+    const auto ins = Instance(map_filename, std::vector<int>({0, 8}),
+                              std::vector<int>({9, 1}));
+    auto &U = ins.G->U;
+    auto CT = CollisionTable(&ins);
+    auto path0 = Path({U[3], U[4], U[3], U[4], U[5]});
+    CT.enrollPath(0, path0);
+    auto SIs_3 = CT.get_safe_intervals(U[3]->id);
+    assert(SIs_3.size() == 2);
+    assert(SIs_3[0] == SI(1, 1));
+    assert(SIs_3[1] == SI(3, CollisionTable::TIME_INF));
+    auto path1 = Path({U[2], U[3], U[11]});
+    CT.enrollPath(1, path1);
+    SIs_3 = CT.get_safe_intervals(U[3]->id);
+    assert(SIs_3.size() == 1);
+    assert(CT.find_safe_interval(U[3]->id, 1) == -1);
+    assert(CT.find_safe_interval(U[3]->id, 3) == 0);
+    assert(CT.find_safe_interval(U[3]->id, 100) == 0);
+    // goal arrival truncates the intervals
+    assert(CT.get_safe_intervals(U[5]->id).size() == 1);
+    assert(CT.get_safe_intervals(U[5]->id)[0] == SI(0, 3));
+    CT.clearPath(0, path0);
+    SIs_3 = CT.get_safe_intervals(U[3]->id);
+    assert(SIs_3.size() == 2);
+    assert(SIs_3[0] == SI(0, 0));
+    assert(SIs_3[1] == SI(2, CollisionTable::TIME_INF));
+  }
+
+  {
+    // edge reservations
+    const auto map_filename = "../assets/empty-8-8.map";
+    const auto ins = Instance(map_filename, std::vector<int>({0, 8}),
+                              std::vector<int>({9, 1}));
+    auto &U = ins.G->U;
+    auto CT = CollisionTable(&ins);
+    auto path0 = Path({U[1], U[0], U[1], U[0], U[1], U[0], U[0], U[1], U[0]});
+    CT.enrollPath(0, path0);
+    // moves 1->0 depart at 0, 2, 4, 7
+    const auto k1 = std::find(U[0]->neighbor.begin(), U[0]->neighbor.end(),
+                              U[1]) -
+                    U[0]->neighbor.begin();
+    const auto k8 = std::find(U[0]->neighbor.begin(), U[0]->neighbor.end(),
+                              U[8]) -
+                    U[0]->neighbor.begin();
+    assert(CT.get_earliest_departure(U[0], k1, 0, 10) == 1);
+    assert(CT.get_earliest_departure(U[0], k1, 4, 10) == 5);
+    assert(CT.get_earliest_departure(U[0], k1, 7, 7) == -1);
+    assert(CT.get_earliest_departure(U[0], k8, 0, 10) == 0);
+    assert(CT.get_latest_departure(U[0], k1, 0, 7) == 6);
+    assert(CT.get_latest_departure(U[0], k1, 0, 4) == 3);
+    assert(CT.get_latest_departure(U[0], k1, 4, 4) == -1);
+    auto path1 = Path({U[9], U[1], U[0], U[8]});
+    CT.enrollPath(1, path1);
+    // moves 1->0 depart at 0, 1, 2, 4, 7
+    assert(CT.get_earliest_departure(U[0], k1, 0, 10) == 3);
+    assert(CT.get_latest_departure(U[0], k1, 0, 2) == -1);
+    CT.clearPath(1, path1);
+    CT.clearPath(0, path0);
+    assert(CT.get_earliest_departure(U[0], k1, 4, 10) == 4);
+  }
+
+  {
+    // more agents than inline capacity
+    const auto map_filename = "../assets/empty-8-8.map";
+    const auto ins = Instance(map_filename, std::vector<int>({0, 1, 2, 3, 4}),
+                              std::vector<int>({0, 1, 2, 3, 4}));
+    auto &U = ins.G->U;
+    auto CT = CollisionTable(&ins);
+    auto paths = Paths(5);
+    for (auto i = 0; i < 5; ++i) {
+      paths[i] = Path({U[8 + i], U[16], U[24 + i]});
+      CT.enrollPath(i, paths[i]);
+    }
+    assert(CT.get_agents_num(U[16]->id, 1) == 5);
+    assert(CT.collision_cnt == 10);
+    auto agents = std::vector<int>();
+    CT.for_each_agent(U[16]->id, 1, [&](int j) { agents.push_back(j); });
+    std::sort(agents.begin(), agents.end());
+    assert(agents == std::vector<int>({0, 1, 2, 3, 4}));
+    CT.clearPath(1, paths[1]);
+    CT.clearPath(3, paths[3]);
+    assert(CT.collision_cnt == 3);
+    for (auto i : {0, 2, 4}) CT.clearPath(i, paths[i]);
+    assert(CT.collision_cnt == 0);
+    assert(CT.overflow.empty());
+    CT.shrink();
+    assert(CT.get_horizon(U[16]->id) == 0);
+  }
+
+  return 0;
+}
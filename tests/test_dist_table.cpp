@@ -11,6 +11,35 @@ int main()
 
     assert(dist_table.get(0, ins.goals[0]) == 0);
     assert(dist_table.get(0, ins.starts[0]) == 16);
+
+    // rows are reused among tables on the same graph
+    auto cache = DistCache(ins.G, 3);
+    auto dist_table1 = DistTable(&ins, &cache);
+    assert(cache.num_misses == 3 && cache.num_hits == 0);
+    assert(dist_table1.get(0, ins.starts[0]) == 16);
+    auto ins2 = Instance(ins.G, ins.goals, {ins.goals[0], ins.goals[0]}, 2);
+    auto dist_table2 = DistTable(&ins2, &cache);
+    assert(cache.num_misses == 3 && cache.num_hits == 1);
+    assert(dist_table2.table[0] == dist_table1.table[0]);
+    assert(dist_table2.table[1] == dist_table1.table[0]);
+
+    // capacity
+    auto ins3 = Instance(ins.G, ins.goals, ins.starts, 3);
+    auto dist_table3 = DistTable(&ins3, &cache);
+    assert(cache.rows.size() == 3);
+    assert(cache.find(ins.goals[0]) == nullptr);
+    assert(dist_table1.get(0, ins.starts[0]) == 16);
+
+    // truncated rows
+    const auto K = (int)ins.G->size();
+    auto dist_table4 = DistTable(&ins, 16, PRIORITY_LOW);
+    auto dist_table5 = DistTable(&ins, 15, PRIORITY_LOW);
+    assert(dist_table4.get(0, ins.starts[0]) == 16);
+    assert(dist_table5.get(0, ins.starts[0]) == K);
+    for (auto v = 0; v < K; ++v) {
+      const auto d = dist_table.get(1, v);
+      assert(dist_table5.get(1, v) == (d <= 15 ? d : K));
+    }
   }
 
   return 0;
@@ -0,0 +1,82 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    // a budget of one thread still has a worker for refiners
+    Executor::NUM_THREADS = 1;
+    assert(get_executor()->threads.size() == 1);
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 200);
+    auto options = PlannerOptions();
+    options.recursive_rate = 0;
+    auto stats = PlannerStats();
+    auto deadline = Deadline(2000);
+    auto solution = solve(ins, 0, &deadline, 0, options, &stats);
+    assert(is_feasible_solution(ins, solution));
+    assert(get_sum_of_loss(solution) < stats.cost_initial_solution);
+  }
+
+  {
+    auto results = ResultQueue<int>();
+    auto executor = Executor(3);
+    auto group = TaskGroup();
+    for (auto k = 0; k < 100; ++k) {
+      executor.submit(group, [&, k] { results.push(k); });
+    }
+    executor.wait(group);
+    assert(group.num_pending == 0);
+    auto values = results.pop_all();
+    assert(values.size() == 100);
+    std::sort(values.begin(), values.end());
+    for (auto k = 0; k < 100; ++k) assert(values[k] == k);
+    assert(results.empty());
+
+    // single producer keeps the order
+    for (auto k = 0; k < 5; ++k) results.push(k);
+    assert(results.pop_all() == std::vector<int>({0, 1, 2, 3, 4}));
+  }
+
+  {
+    // without workers, the waiting thread runs only its own group
+    auto executor = Executor(0);
+    auto group1 = TaskGroup();
+    auto group2 = TaskGroup();
+    auto order = std::vector<int>();
+    executor.submit(group1, [&] { order.push_back(1); });
+    executor.submit(group2, [&] { order.push_back(2); }, PRIORITY_LOW);
+    executor.submit(group2, [&] { order.push_back(3); }, PRIORITY_HIGH);
+    executor.wait(group2);
+    assert(order == std::vector<int>({3, 2}));
+    assert(group1.num_pending == 1);
+    executor.wait(group1);
+    assert(order.size() == 3);
+
+    // nested groups
+    auto group3 = TaskGroup();
+    auto sum = 0;
+    executor.submit(group3, [&] {
+      auto group4 = TaskGroup();
+      for (auto k = 0; k < 3; ++k) executor.submit(group4, [&] { ++sum; });
+      executor.wait(group4);
+    });
+    executor.wait(group3);
+    assert(sum == 3);
+  }
+
+  {
+    auto token = CancelToken();
+    auto token_child = CancelToken(&token);
+    auto deadline = Deadline(1000000, &token);
+    auto deadline_child = Deadline(&deadline, &token_child);
+    assert(!is_expired(&deadline_child));
+    token.cancel();
+    assert(token_child.is_cancelled());
+    assert(is_expired(&deadline));
+    assert(is_expired(&deadline_child));
+  }
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    options.horizon = 5;
+    auto lifelong = Lifelong(&ins, options);
+    auto MT = std::mt19937(0);
+
+    // a new goal is given on arrival
+    auto C = ins.starts;
+    auto num_tasks = 0;
+    for (auto k = 0; k < 100; ++k) {
+      for (size_t i = 0; i < ins.N; ++i) {
+        if (C[i] != lifelong.goals_requested[i]) continue;
+        ++num_tasks;
+        auto &V = ins.G->V;
+        auto goal = C[i];
+        while (goal == C[i]) goal = V[get_random_int(MT, 0, V.size() - 1)];
+        lifelong.set_goal(i, goal);
+      }
+      auto deadline = Deadline(1000);
+      auto plan = lifelong.tick(C, &deadline, k);
+      assert(plan.size() >= 2 && (int)plan.size() <= options.horizon + 1);
+      auto ins_window = Instance(ins.G, plan.front(), plan.back(), ins.N);
+      assert(is_feasible_solution(ins_window, plan));
+      C = plan[1];
+    }
+    assert(num_tasks > 0);
+    assert(lifelong.num_goal_updates == num_tasks);
+
+    // distances of the latest goals
+    lifelong.sync();
+    assert(lifelong.get_num_pending() == 0);
+    assert(lifelong.goals == lifelong.goals_requested);
+    for (size_t i = 0; i < ins.N; ++i) {
+      assert(lifelong.D->get(i, lifelong.goals[i]) == 0);
+    }
+  }
+
+  {
+    // known goals are applied immediately
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 10);
+    auto options = PlannerOptions();
+    options.horizon = 5;
+    auto lifelong = Lifelong(&ins, options);
+    lifelong.set_goal(0, ins.goals[1]);
+    assert(lifelong.goals[0] == ins.goals[1]);
+    assert(lifelong.get_num_pending() == 0);
+    assert(lifelong.D->get(0, ins.goals[1]) == 0);
+    assert(lifelong.num_rows_computed == 0);
+  }
+
+  return 0;
+}
@@ -19,5 +19,178 @@ int main()
     assert(solution.empty());
   }
 
+  {
+    // pipelined mode
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto options = PlannerOptions();
+    options.flg_pipeline = true;
+    auto deadline = Deadline(500);
+    auto planner = Planner(&ins, 0, &deadline, 0, 0, nullptr, options);
+    auto solution = planner.solve();
+    assert(is_feasible_solution(ins, solution));
+    assert(planner.spec.num_hits > 0);
+  }
+
+  {
+    // SUO in background, PIBTs pick up published snapshots
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 200);
+    auto options = PlannerOptions();
+    options.flg_scatter_async = true;
+    auto deadline = Deadline(1000);
+    auto planner = Planner(&ins, 0, &deadline, 0, 0, nullptr, options);
+    auto solution = planner.solve();
+    assert(is_feasible_solution(ins, solution));
+    assert(planner.scatter != nullptr && planner.scatter->flg_async);
+    assert(planner.scatter->get_scatter_data() != nullptr);
+    auto &pibts = planner.pibts;
+    assert(std::any_of(pibts.begin(), pibts.end(), [](auto pibt) {
+      return pibt->scatter_data != nullptr;
+    }));
+  }
+
+  {
+    // concurrent searchers
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto options = PlannerOptions();
+    options.searcher_num = 3;
+    auto deadline = Deadline(500);
+    auto planner = Planner(&ins, 0, &deadline, 0, 0, nullptr, options);
+    auto solution = planner.solve();
+    assert(is_feasible_solution(ins, solution));
+    assert(planner.stats.search_iter > 0);
+  }
+
+  {
+    // concurrent searchers prove optimality
+    const auto ins = Instance("../assets/empty-8-8.map", 3, 0);
+    auto options = PlannerOptions();
+    options.searcher_num = 2;
+    auto planner = Planner(&ins, 0, nullptr, 0, 0, nullptr, options);
+    auto solution = planner.solve();
+    assert(is_feasible_solution(ins, solution));
+    assert(planner.OPEN.empty());
+  }
+
+  {
+    // portfolio
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto deadline = Deadline(500);
+    auto solution = solve_portfolio(ins, 3, 0, &deadline);
+    assert(is_feasible_solution(ins, solution));
+  }
+
+  {
+    // portfolio is no worse than its first member alone
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    options.flg_scatter = false;
+    auto deadline1 = Deadline(10000);
+    auto solution1 = solve(ins, 0, &deadline1, 0, options);
+    auto deadline2 = Deadline(10000);
+    auto solution2 = solve_portfolio(ins, 8, 0, &deadline2, 0, options);
+    assert(is_feasible_solution(ins, solution1));
+    assert(is_feasible_solution(ins, solution2));
+    assert(get_sum_of_loss(solution2) <= get_sum_of_loss(solution1));
+  }
+
+  {
+    // portfolio stops when a member proves optimality
+    const auto ins = Instance("../assets/empty-8-8.map", 3, 0);
+    auto deadline = Deadline(10000);
+    auto solution = solve_portfolio(ins, 3, 0, &deadline);
+    assert(is_feasible_solution(ins, solution));
+    assert(deadline.elapsed_ms() < 5000);
+  }
+
+  {
+    // concurrent solves with different options
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto options1 = PlannerOptions();
+    options1.flg_star = false;
+    auto options2 = PlannerOptions();
+    options2.pibt_num = 1;
+    options2.flg_scatter = false;
+    auto deadline = Deadline(500);
+    auto stats1 = PlannerStats();
+    auto stats2 = PlannerStats();
+    auto solution2 = Solution();
+    auto th = std::thread(
+        [&] { solution2 = solve(ins, 0, &deadline, 1, options2, &stats2); });
+    auto solution1 = solve(ins, 0, &deadline, 0, options1, &stats1);
+    th.join();
+    assert(is_feasible_solution(ins, solution1));
+    assert(is_feasible_solution(ins, solution2));
+    assert(stats1.num_high_level_nodes > 0);
+    assert(stats1.num_low_level_nodes >= stats1.num_high_level_nodes);
+    assert(stats1.cost_initial_solution >= 0);
+    assert(stats2.num_high_level_nodes > 0);
+  }
+
+  {
+    // anytime output
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto reported = std::vector<IncumbentPtr>();
+    auto options = PlannerOptions();
+    options.on_improvement = [&](IncumbentPtr solution, double) {
+      reported.push_back(solution);
+    };
+    auto deadline = Deadline(1000);
+    auto solution = solve(ins, 0, &deadline, 0, options);
+    assert(!reported.empty());
+    for (size_t k = 0; k < reported.size(); ++k) {
+      assert(is_feasible_solution(ins, reported[k]->get_solution()));
+      if (k > 0) assert(reported[k]->loss < reported[k - 1]->loss);
+    }
+    assert(reported.back()->loss == get_sum_of_loss(solution));
+
+    // the initial solution is reported also without refinement
+    reported.clear();
+    options.flg_star = false;
+    auto deadline_init = Deadline(1000);
+    solution = solve(ins, 0, &deadline_init, 0, options);
+    assert(reported.size() == 1);
+    assert(reported[0]->loss == get_sum_of_loss(solution));
+  }
+
+  {
+    // fast-first mode
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto options = PlannerOptions();
+    options.flg_fast_first = true;
+    auto deadline = Deadline(1000);
+    auto stats = PlannerStats();
+    auto solution = solve(ins, 0, &deadline, 0, options, &stats);
+    assert(is_feasible_solution(ins, solution));
+    assert(stats.cost_initial_solution >= get_sum_of_loss(solution));
+
+    // without refinement, identical to vanilla LaCAM
+    options.flg_star = false;
+    auto options_vanilla = options;
+    options_vanilla.flg_fast_first = false;
+    options_vanilla.pibt_num = 1;
+    options_vanilla.flg_scatter = false;
+    auto deadline_init = Deadline(1000);
+    auto solution1 = solve(ins, 0, &deadline_init, 0, options);
+    auto solution2 = solve(ins, 0, &deadline_init, 0, options_vanilla);
+    assert(solution1 == solution2);
+  }
+
   return 0;
 }
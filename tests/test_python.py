@@ -0,0 +1,48 @@
+"""smoke test of python/lacam3.py through the shared library"""
+
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.join(ROOT, "python"))
+
+import lacam3  # noqa: E402
+
+
+def main():
+    session = lacam3.Session(
+        os.path.join(ROOT, "assets", "random-32-32-10.map"), star=False
+    )
+    assert session.width == 32 and session.height == 32
+
+    starts, goals = [0, 1, 2], [33, 34, 35]
+    solution = session.solve(starts, goals, time_limit_ms=1000)
+    assert solution.status == lacam3.SUCCESS
+    assert solution.N == 3 and solution.T >= 2
+    assert solution.paths[0, 0] == 0 and solution.paths[solution.T - 1, 2] == 35
+    paths = solution.paths.tolist()
+    assert paths[0] == starts and paths[-1] == goals
+
+    # views keep the buffer alive
+    view = solution.paths
+    del solution
+    assert view.tolist() == paths
+
+    buf = bytearray(4 * len(paths) * 3)
+    status, T = session.solve_into(starts, goals, buf, time_limit_ms=1000)
+    assert status == lacam3.SUCCESS and T == len(paths)
+    assert memoryview(buf).cast("i").tolist()[-3:] == goals
+
+    assert session.solve([0, 0], goals[:2]).status == lacam3.INVALID
+    assert session.solve([], []).status == lacam3.INVALID
+    assert session.solve_into([], [], bytearray(16)) == (lacam3.INVALID, 0)
+    with_error = False
+    try:
+        lacam3.Session(os.path.join(ROOT, "assets", "none.map"))
+    except FileNotFoundError:
+        with_error = True
+    assert with_error
+
+
+if __name__ == "__main__":
+    main()
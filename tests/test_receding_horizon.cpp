@@ -0,0 +1,89 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    options.horizon = 5;
+    auto controller = RecedingHorizon(&ins, options);
+
+    // two steps are executed at every tick
+    auto C = ins.starts;
+    for (auto k = 0; k < 200 && !is_same_config(C, ins.goals); ++k) {
+      auto deadline = Deadline(1000);
+      auto plan = controller.tick(C, &deadline, k);
+      assert(plan.size() >= 2 && (int)plan.size() <= options.horizon + 1);
+      auto ins_window = Instance(ins.G, plan.front(), plan.back(), ins.N);
+      assert(is_feasible_solution(ins_window, plan));
+      if ((int)plan.size() < options.horizon + 1) {
+        assert(is_same_config(plan.back(), ins.goals));
+      }
+      C = plan[std::min(2, (int)plan.size() - 1)];
+    }
+    assert(is_same_config(C, ins.goals));
+    assert(controller.num_ticks > 1);
+  }
+
+  {
+    // all agents get closer to their goals
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    options.flg_scatter = false;
+    options.horizon = 30;
+    options.flg_horizon_progress = true;
+    auto controller = RecedingHorizon(&ins, options);
+    auto D = DistTable(ins);
+    auto deadline = Deadline(1000);
+    auto plan = controller.tick(ins.starts, &deadline);
+    assert(plan.size() >= 2);
+    if ((int)plan.size() < options.horizon + 1) {
+      for (size_t i = 0; i < ins.N; ++i) {
+        assert(plan.back()[i] == ins.goals[i] ||
+               D.get(i, plan.back()[i]) < D.get(i, ins.starts[i]));
+      }
+    }
+  }
+
+  {
+    // a shorter plan when the budget is exhausted
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    options.horizon = 1000000;
+    auto controller = RecedingHorizon(&ins, options);
+    auto deadline = Deadline(50);
+    auto plan = controller.tick(ins.starts, &deadline);
+    auto ins_window = Instance(ins.G, plan.front(), plan.back(), ins.N);
+    assert(plan.size() >= 2);
+    assert(is_feasible_solution(ins_window, plan));
+  }
+
+  {
+    // windowed anytime search with concurrent searchers
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 100);
+    auto options = PlannerOptions();
+    options.flg_refiner = false;
+    options.searcher_num = 2;
+    options.horizon = 5;
+    auto deadline = Deadline(300);
+    auto planner = Planner(&ins, 0, &deadline, 0, 0, nullptr, options);
+    auto plan = planner.solve();
+    auto ins_window = Instance(ins.G, plan.front(), plan.back(), ins.N);
+    assert(plan.size() >= 2 && (int)plan.size() <= options.horizon + 1);
+    assert(is_feasible_solution(ins_window, plan));
+  }
+
+  return 0;
+}
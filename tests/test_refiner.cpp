@@ -0,0 +1,120 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto D = DistTable(ins);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    auto planner = Planner(&ins, 0, nullptr, 0, 0, &D, options);
+    auto solution = planner.solve();
+    assert(is_feasible_solution(ins, solution));
+
+    auto session = RefinerSession(&ins, &D, 0);
+    assert(session.sync(solution) == (int)ins.N);
+    assert(session.sync(solution) == 0);  // no diff
+    for (auto k = 0; k < 3; ++k) {
+      auto loss = get_sum_of_loss(session.get_solution());
+      auto updated = session.refine(nullptr, k);
+      auto solution_new = session.get_solution();
+      assert(is_feasible_solution(ins, solution_new));
+      assert(get_sum_of_loss(solution_new) <= loss);
+      assert(std::is_sorted(updated.begin(), updated.end()));
+    }
+
+    // back to the original, only changed paths are replaced
+    auto session2 = RefinerSession(&ins, &D, 0);
+    session2.sync(session.get_solution());
+    assert(session2.sync(solution) == session.sync(solution));
+    assert(session.CT.collision_cnt == 0);
+
+    // cooperative
+    auto session3 = RefinerSession(&ins, &D, 0, 0, 3);
+    session3.sync(solution);
+    for (auto k = 0; k < 3; ++k) {
+      auto loss = get_sum_of_loss(session3.get_solution());
+      session3.refine(nullptr, k);
+      auto solution_new = session3.get_solution();
+      assert(is_feasible_solution(ins, solution_new));
+      assert(get_sum_of_loss(solution_new) <= loss);
+      for (auto worker : session3.workers) {
+        assert(worker->paths == session3.paths);
+      }
+    }
+
+    // snapshots & diffs
+    auto incumbent = std::make_shared<const Incumbent>(solution);
+    assert(incumbent->get_solution() == solution);
+    assert(incumbent->loss == get_sum_of_loss(solution));
+    auto session6 = RefinerSession(&ins, &D, 0);
+    assert(session6.sync(*incumbent) == (int)ins.N);
+    assert(session6.sync(*incumbent) == 0);
+    auto updated = session6.refine(nullptr);
+    auto diff = session6.get_diff(incumbent, updated);
+    assert(diff.agents == updated);
+    auto incumbent_next = Incumbent(*incumbent, diff);
+    assert(incumbent_next.get_solution() == session6.get_solution());
+    assert(incumbent_next.loss == get_sum_of_loss(session6.get_solution()));
+    for (size_t i = 0; i < ins.N; ++i) {
+      auto changed = std::count(updated.begin(), updated.end(), i) > 0;
+      assert(changed ^ (incumbent_next.paths[i] == incumbent->paths[i]));
+    }
+    for (auto t = 0; t <= incumbent->makespan; ++t) {
+      if (t >= diff.t_min && t <= diff.t_max) continue;
+      assert(incumbent->get_config(t) == incumbent_next.get_config(t));
+    }
+    // modified agents are restored
+    assert(session6.sync(*incumbent) == (int)updated.size());
+    assert(session6.get_solution() == solution);
+
+    // PIBT-based repair
+    auto session5 = RefinerSession(&ins, &D, 0);
+    session5.sync(solution);
+    for (auto k = 0; k < 5; ++k) {
+      auto loss = get_sum_of_loss(session5.get_solution());
+      auto updated = session5.repair(nullptr, k);
+      auto solution_new = session5.get_solution();
+      assert(is_feasible_solution(ins, solution_new));
+      assert(updated.empty() ? get_sum_of_loss(solution_new) == loss
+                             : get_sum_of_loss(solution_new) < loss);
+    }
+
+    // adaptive
+    for (auto num_threads : {1, 2}) {
+      auto session4 = RefinerSession(&ins, &D, 0, 0, num_threads, true);
+      session4.sync(solution);
+      for (auto k = 0; k < 3; ++k) {
+        auto loss = get_sum_of_loss(session4.get_solution());
+        session4.refine(nullptr, k);
+        auto solution_new = session4.get_solution();
+        assert(is_feasible_solution(ins, solution_new));
+        assert(get_sum_of_loss(solution_new) <= loss);
+        for (auto &nb : session4.neighborhoods) {
+          auto agents = std::set<int>(nb.agents.begin(), nb.agents.end());
+          assert(agents.size() == nb.agents.size());
+          assert(nb.generator >= 0 && nb.generator < 3);
+        }
+      }
+    }
+  }
+
+  {
+    // no agents
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(map_filename, 1);
+    const auto ins_empty = Instance(ins.G, Config(), Config(), 0);
+    auto D = DistTable(ins_empty);
+    const auto solution = Solution({Config(), Config()});
+    auto deadline = Deadline(100);
+    refine(&ins_empty, &deadline, solution, &D);
+    auto session = RefinerSession(&ins_empty, &D, 0);
+    assert(session.refine(&deadline).empty());
+    assert(session.repair(&deadline).empty());
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <cassert>
+#include <lacam.hpp>
+
+// each path moves along edges from the start to the goal, and the collision
+// table matches the committed paths
+static void check_scatter(const Instance &ins, DistTable &D, Scatter &scatter)
+{
+  auto CT = CollisionTable(&ins);
+  auto sum_of_path_length = 0;
+  for (size_t i = 0; i < ins.N; ++i) {
+    auto &path = scatter.paths[i];
+    assert(!path.empty());
+    assert(path.front() == ins.starts[i] && path.back() == ins.goals[i]);
+    for (size_t t = 1; t < path.size(); ++t) {
+      auto &C = path[t - 1]->neighbor;
+      assert(std::find(C.begin(), C.end(), path[t]) != C.end());
+    }
+    assert((int)path.size() - 1 <=
+           D.get(i, ins.starts[i]) + scatter.cost_margin);
+    sum_of_path_length += path.size() - 1;
+    CT.enrollPath(i, path);
+  }
+  assert(CT.collision_cnt == scatter.CT.collision_cnt);
+  assert(sum_of_path_length == scatter.sum_of_path_length);
+}
+
+int main()
+{
+  {
+    // batched construction is comparable to the sequential one
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 400);
+    auto D = DistTable(ins);
+
+    auto scatter1 = Scatter(&ins, &D, nullptr, 0, -1, 10, false, 1);
+    scatter1.construct();
+    check_scatter(ins, D, scatter1);
+    assert(scatter1.num_replans == 0);
+
+    auto scatter4 = Scatter(&ins, &D, nullptr, 0, -1, 10, false, 4);
+    scatter4.construct();
+    check_scatter(ins, D, scatter4);
+    // within 20% (+10) of the sequential run
+    assert(scatter4.CT.collision_cnt <= scatter1.CT.collision_cnt * 1.2 + 10);
+    // paths are planned against a frozen table, independent of scheduling
+    assert(scatter4.num_replans > 0);
+    auto scatter4_2 = Scatter(&ins, &D, nullptr, 0, -1, 10, false, 4);
+    scatter4_2.construct();
+    assert(scatter4_2.num_replans == scatter4.num_replans);
+    assert(scatter4_2.CT.collision_cnt == scatter4.CT.collision_cnt);
+  }
+
+  {
+    // lookup of the next vertex
+    const auto ins = Instance("../assets/empty-8-8.map", 1, 0);
+    auto &U = ins.G->U;
+    const auto paths = std::vector<Path>({
+        Path({U[0], U[1], U[9], U[1], U[2]}),  // revisiting
+        Path(),                                // empty
+        Path({U[5]}),                          // one vertex
+        Path({U[3], U[4]}),
+    });
+    auto data = ScatterData(paths);
+    assert(data.get(0, U[0]->id) == U[1]);
+    assert(data.get(0, U[1]->id) == U[2]);  // the latest visit
+    assert(data.get(0, U[9]->id) == U[1]);
+    assert(data.get(0, U[2]->id) == nullptr);  // end of the path
+    assert(data.get(0, U[3]->id) == nullptr);  // off the path
+    for (auto v : {U[0], U[3], U[5]}) {
+      assert(data.get(1, v->id) == nullptr);
+      assert(data.get(2, v->id) == nullptr);
+    }
+    assert(data.get(3, U[3]->id) == U[4]);
+    assert(data.get(3, U[4]->id) == nullptr);
+    assert(data.get(3, U[1]->id) == nullptr);
+  }
+
+  return 0;
+}
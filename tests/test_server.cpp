@@ -0,0 +1,112 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 20);
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    auto session = SolverSession(map_filename, options);
+    const auto socket_path =
+        "/tmp/lacam3_test_server_" + std::to_string(::getpid()) + ".sock";
+    auto server = Server(socket_path, {&session});
+    assert(server.open());
+    auto th = std::thread([&] { server.run(); });
+
+    auto req = protocol::Request{0, 1000, 0, {}, {}};
+    for (auto v : ins.starts) req.starts.push_back(v->index);
+    for (auto v : ins.goals) req.goals.push_back(v->index);
+    auto fd = protocol::connect(socket_path);
+    assert(fd >= 0);
+    auto res = protocol::Response();
+    for (auto k = 0; k < 2; ++k) {
+      assert(protocol::write_request(fd, req));
+      assert(protocol::read_response(fd, res));
+      assert(res.status == protocol::SUCCESS);
+      assert(res.solution.front() == req.starts);
+      assert(res.solution.back() == req.goals);
+      auto solution = Solution();
+      for (auto &Q : res.solution) {
+        solution.emplace_back();
+        for (auto k : Q) solution.back().push_back(session.G->U[k]);
+      }
+      assert(is_feasible_solution(ins, solution));
+    }
+
+    // invalid requests keep the connection
+    auto req_invalid = req;
+    req_invalid.map_id = 1;
+    assert(protocol::write_request(fd, req_invalid));
+    assert(protocol::read_response(fd, res));
+    assert(res.status == protocol::INVALID && res.solution.empty());
+    req_invalid = req;
+    req_invalid.starts[0] = -1;
+    assert(protocol::write_request(fd, req_invalid));
+    assert(protocol::read_response(fd, res));
+    assert(res.status == protocol::INVALID);
+
+    // duplicated starts or goals
+    for (auto arr : {&protocol::Request::starts, &protocol::Request::goals}) {
+      req_invalid = req;
+      (req_invalid.*arr)[1] = (req_invalid.*arr)[0];
+      assert(protocol::write_request(fd, req_invalid));
+      assert(protocol::read_response(fd, res));
+      assert(res.status == protocol::INVALID && res.solution.empty());
+    }
+
+    // no agents, the server keeps running
+    req_invalid = protocol::Request{0, 500, 0, {}, {}};
+    assert(protocol::write_request(fd, req_invalid));
+    assert(protocol::read_response(fd, res));
+    assert(res.status == protocol::INVALID && res.solution.empty());
+    assert(session.solve(Config(), Config()).empty());
+    assert(protocol::write_request(fd, req));
+    assert(protocol::read_response(fd, res));
+    assert(res.status == protocol::SUCCESS);
+
+    // the server closes connections on stop
+    server.stop();
+    th.join();
+    assert(!protocol::read_response(fd, res));
+    ::close(fd);
+    assert(session.num_requests == 4);
+  }
+
+  {
+    // time limits are capped, running requests are cancelled on stop
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 50);
+    auto session = SolverSession(map_filename);  // refining until deadline
+    const auto socket_path =
+        "/tmp/lacam3_test_server_" + std::to_string(::getpid()) + ".sock";
+    auto req = protocol::Request{0, INT32_MAX, 0, {}, {}};
+    for (auto v : ins.starts) req.starts.push_back(v->index);
+    for (auto v : ins.goals) req.goals.push_back(v->index);
+    auto res = protocol::Response();
+
+    for (auto max_time_limit_ms : {300, 60000}) {
+      auto server = Server(socket_path, {&session}, 0, max_time_limit_ms);
+      assert(server.open());
+      auto th = std::thread([&] { server.run(); });
+      auto fd = protocol::connect(socket_path);
+      auto deadline = Deadline();
+      assert(protocol::write_request(fd, req));
+      if (max_time_limit_ms < 1000) {
+        assert(protocol::read_response(fd, res));
+        assert(res.status == protocol::SUCCESS);
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+      }
+      server.stop();
+      th.join();
+      assert(deadline.elapsed_ms() < 2000);
+      ::close(fd);
+    }
+  }
+
+  return 0;
+}
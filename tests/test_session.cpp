@@ -0,0 +1,53 @@
+#include <cassert>
+#include <lacam.hpp>
+
+int main()
+{
+  {
+    const auto scen_filename = "../assets/random-32-32-10-random-1.scen";
+    const auto map_filename = "../assets/random-32-32-10.map";
+    const auto ins = Instance(scen_filename, map_filename, 20);
+    auto get_indexes = [](const Config &C) {
+      auto indexes = std::vector<int>();
+      for (auto v : C) indexes.push_back(v->index);
+      return indexes;
+    };
+
+    auto options = PlannerOptions();
+    options.flg_star = false;
+    auto session = SolverSession(map_filename, options);
+    auto starts = get_indexes(ins.starts);
+    auto goals = get_indexes(ins.goals);
+    auto stats = PlannerStats();
+    auto solution = session.solve(starts, goals, nullptr, 0, &stats);
+    assert(!solution.empty());
+    assert(stats.cost_initial_solution >= 0);
+    assert(get_indexes(solution.front()) == starts);
+    assert(get_indexes(solution.back()) == goals);
+    assert(session.dist_cache.num_misses == 20);
+
+    // reverse, distances to the original starts are computed
+    auto solution_rev = session.solve(goals, starts);
+    assert(get_indexes(solution_rev.back()) == starts);
+    assert(session.dist_cache.num_misses == 40);
+
+    // warm
+    session.solve(starts, goals);
+    assert(session.dist_cache.num_misses == 40);
+    assert(session.dist_cache.num_hits == 20);
+    assert(session.num_requests == 3);
+
+    // invalid requests
+    assert(session.solve(starts, {goals[0]}).empty());
+    auto &U = session.G->U;
+    const int obstacle = std::find(U.begin(), U.end(), nullptr) - U.begin();
+    assert(session.solve(std::vector<int>({-1}), {goals[0]}).empty());
+    assert(session.solve(std::vector<int>({obstacle}), {goals[0]}).empty());
+    const auto pair = std::vector<int>({starts[0], starts[1]});
+    const auto same = std::vector<int>({goals[0], goals[0]});
+    assert(session.solve(pair, same).empty());
+    assert(session.solve(same, pair).empty());
+  }
+
+  return 0;
+}
@@ -30,6 +30,26 @@ int main()
                           ins.G->V[2], ins.G->V[3]}));
   }
 
+  {
+    // reused context, across the wrap-around of its stamp
+    const auto scen_filename = "../tests/assets/sapp.scen";
+    const auto map_filename = "../tests/assets/sapp.map";
+    const auto ins = Instance(scen_filename, map_filename, 1);
+    auto D = DistTable(ins);
+    auto CT = CollisionTable(&ins);
+    auto ctx = SIPPContext();
+    const auto i = 0;
+    const auto expected =
+        Path({ins.G->V[0], ins.G->V[1], ins.G->V[2], ins.G->V[3]});
+    ctx.stamp = UINT32_MAX - 2;
+    for (auto k = 0; k < 4; ++k) {
+      auto path = sipp(i, ins.starts[i], ins.goals[i], &D, &CT, nullptr,
+                       INT_MAX, &ctx);
+      assert(path == expected);
+    }
+    assert(ctx.stamp == 2);
+  }
+
   {
     const auto scen_filename = "../tests/assets/sapp2.scen";
     const auto map_filename = "../tests/assets/sapp2.map";